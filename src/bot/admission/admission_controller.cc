@@ -0,0 +1,230 @@
+#include "admission_controller.h"
+
+#include <algorithm>
+#include <exception>
+#include <numeric>
+
+AdmissionController::AdmissionController(std::size_t const command_concurrency, std::size_t const message_concurrency, std::size_t const presence_concurrency, std::size_t const presence_queue_limit) {
+  auto const concurrency_per_class = std::array<std::size_t, kEventClasses>{command_concurrency, message_concurrency, presence_concurrency};
+  for (std::size_t lane_index = 0; lane_index < kEventClasses; ++lane_index) {
+    state_->lanes[lane_index].concurrency = std::max<std::size_t>(concurrency_per_class[lane_index], 1);
+  }
+  state_->lanes[static_cast<std::size_t>(EventClass::kPresence)].queue_limit = presence_queue_limit;
+
+  dispatcher_ = std::thread(&AdmissionController::Run, this);
+}
+
+AdmissionController::~AdmissionController() {
+  {
+    std::scoped_lock<std::mutex> const mutex_lock(state_->mutex);
+    state_->closed = true;
+    state_->stopping = true;
+  }
+  state_->work_condition.notify_all();
+
+  if (dispatcher_.joinable()) {
+    dispatcher_.join();
+  }
+}
+
+void AdmissionController::Submit(EventClass const event_class, Work work, Dropped dropped) {
+  std::optional<Item> dropped_item;
+  {
+    std::scoped_lock<std::mutex> const mutex_lock(state_->mutex);
+    if (state_->closed) {
+      dropped_item = Item{.key = std::nullopt, .work = std::move(work), .dropped = std::move(dropped)};
+    } else {
+      auto& lane = state_->lanes[static_cast<std::size_t>(event_class)];
+      lane.queue.push_back(Item{.key = std::nullopt, .work = std::move(work), .dropped = std::move(dropped)});
+      ++lane.stats.admitted;
+      dropped_item = lane.ShedOverLimit();
+    }
+  }
+  state_->work_condition.notify_all();
+  NotifyDropped(std::move(dropped_item));
+}
+
+void AdmissionController::Submit(EventClass const event_class, Key const key, Work work) {
+  std::optional<Item> dropped_item;
+  {
+    std::scoped_lock<std::mutex> const mutex_lock(state_->mutex);
+    if (state_->closed) {
+      return;
+    }
+
+    auto& lane = state_->lanes[static_cast<std::size_t>(event_class)];
+    auto const it_queued_key = lane.queued_keys.find(key);
+    if (lane.queued_keys.cend() != it_queued_key) {
+      it_queued_key->second->work = std::move(work);
+      ++lane.stats.coalesced;
+      return;
+    }
+
+    lane.queue.push_back(Item{.key = key, .work = std::move(work)});
+    lane.queued_keys[key] = std::prev(lane.queue.end());
+    ++lane.stats.admitted;
+    dropped_item = lane.ShedOverLimit();
+  }
+  state_->work_condition.notify_all();
+  NotifyDropped(std::move(dropped_item));
+}
+
+void AdmissionController::Submit(EventClass const event_class, std::chrono::steady_clock::time_point const due, Work work, Dropped dropped) {
+  std::optional<Item> dropped_item;
+  {
+    std::scoped_lock<std::mutex> const mutex_lock(state_->mutex);
+    if (state_->closed) {
+      dropped_item = Item{.key = std::nullopt, .work = std::move(work), .dropped = std::move(dropped)};
+    } else {
+      state_->delayed.emplace(due, std::pair{static_cast<std::size_t>(event_class), Item{.key = std::nullopt, .work = std::move(work), .dropped = std::move(dropped)}});
+    }
+  }
+  state_->work_condition.notify_all();
+  NotifyDropped(std::move(dropped_item));
+}
+
+void AdmissionController::Close() noexcept {
+  decltype(state_->delayed) delayed;
+  {
+    std::scoped_lock<std::mutex> const mutex_lock(state_->mutex);
+    state_->closed = true;
+    delayed.swap(state_->delayed);
+  }
+  state_->idle_condition.notify_all();
+
+  for (auto& [due, lane_index_and_item] : delayed) {
+    NotifyDropped(std::move(lane_index_and_item.second));
+  }
+}
+
+void AdmissionController::WaitIdle() noexcept {
+  std::unique_lock<std::mutex> mutex_lock(state_->mutex);
+  state_->idle_condition.wait(mutex_lock, [this]() { return 0 == state_->GetPendingWork(); });
+}
+
+std::size_t AdmissionController::Drain(std::chrono::steady_clock::time_point const deadline) noexcept {
+  std::size_t abandoned_work{};
+  {
+    std::unique_lock<std::mutex> mutex_lock(state_->mutex);
+    state_->idle_condition.wait_until(mutex_lock, deadline, [this]() { return 0 == state_->GetPendingWork(); });
+
+    abandoned_work = state_->GetPendingWork();
+    state_->closed = true;
+    state_->stopping = true;
+  }
+  state_->work_condition.notify_all();
+
+  if (dispatcher_.joinable()) {
+    dispatcher_.join();
+  }
+
+  if (0 != abandoned_work) {
+    logger_.Warn("Abandoned {} queued or in-flight handlers after the drain deadline", abandoned_work);
+  }
+
+  return abandoned_work;
+}
+
+AdmissionController::Stats AdmissionController::GetStats(EventClass const event_class) const noexcept {
+  std::scoped_lock<std::mutex> const mutex_lock(state_->mutex);
+
+  auto const& lane = state_->lanes[static_cast<std::size_t>(event_class)];
+  auto stats = lane.stats;
+  stats.queued = lane.queue.size();
+  return stats;
+}
+
+std::optional<AdmissionController::Item> AdmissionController::Lane::ShedOverLimit() noexcept {
+  if ((0 == queue_limit) || (queue.size() <= queue_limit)) {
+    return std::nullopt;
+  }
+
+  if (queue.front().key) {
+    queued_keys.erase(*queue.front().key);
+  }
+  auto item = std::move(queue.front());
+  queue.pop_front();
+  ++stats.shed;
+  return item;
+}
+
+std::size_t AdmissionController::State::GetPendingWork() const noexcept {
+  return std::accumulate(lanes.cbegin(), lanes.cend(), std::size_t{}, [](std::size_t const pending_work, auto const& lane) {
+    return pending_work + lane.queue.size() + lane.stats.in_flight;
+  }) + delayed.size();
+}
+
+void AdmissionController::NotifyDropped(std::optional<Item> item) noexcept {
+  if (item && item->dropped) {
+    item->dropped();
+  }
+}
+
+dpp::job AdmissionController::Execute(std::shared_ptr<State> state, std::size_t const lane_index, Work work) {
+  try {
+    co_await work();
+  } catch (std::exception const& exception) {
+    LoggerFactory::Get().Create("Admission Controller").Error("Handler failed. Exception: '{}'", exception.what());
+  }
+
+  {
+    std::scoped_lock<std::mutex> const mutex_lock(state->mutex);
+    --state->lanes[lane_index].stats.in_flight;
+  }
+  state->work_condition.notify_all();
+  state->idle_condition.notify_all();
+}
+
+std::vector<std::optional<AdmissionController::Item>> AdmissionController::QueueDueWork() noexcept {
+  std::vector<std::optional<Item>> shed_items;
+  auto const now = std::chrono::steady_clock::now();
+  while (!state_->delayed.empty() && (state_->delayed.begin()->first <= now)) {
+    auto delayed_node = state_->delayed.extract(state_->delayed.begin());
+    auto& [lane_index, item] = delayed_node.mapped();
+    auto& lane = state_->lanes[lane_index];
+    lane.queue.push_back(std::move(item));
+    ++lane.stats.admitted;
+    if (auto shed_item = lane.ShedOverLimit()) {
+      shed_items.push_back(std::move(shed_item));
+    }
+  }
+
+  return shed_items;
+}
+
+void AdmissionController::Run() {
+  std::unique_lock<std::mutex> mutex_lock(state_->mutex);
+  while (!state_->stopping) {
+    auto shed_items = QueueDueWork();
+    if (!shed_items.empty()) {
+      mutex_lock.unlock();
+      for (auto& shed_item : shed_items) {
+        NotifyDropped(std::move(shed_item));
+      }
+      mutex_lock.lock();
+      continue;
+    }
+
+    auto const it_lane = std::ranges::find_if(state_->lanes, [](auto const& lane) { return !lane.queue.empty() && (lane.stats.in_flight < lane.concurrency); });
+    if (state_->lanes.end() == it_lane) {
+      if (state_->delayed.empty()) {
+        state_->work_condition.wait(mutex_lock);
+      } else {
+        state_->work_condition.wait_until(mutex_lock, state_->delayed.begin()->first);
+      }
+      continue;
+    }
+
+    auto const lane_index = static_cast<std::size_t>(std::distance(state_->lanes.begin(), it_lane));
+    auto item = std::move(it_lane->queue.front());
+    if (item.key) {
+      it_lane->queued_keys.erase(*item.key);
+    }
+    it_lane->queue.pop_front();
+    ++it_lane->stats.in_flight;
+
+    mutex_lock.unlock();
+    Execute(state_, lane_index, std::move(item.work));
+    mutex_lock.lock();
+  }
+}
\ No newline at end of file
@@ -0,0 +1,116 @@
+#pragma once
+
+#include <array>
+#include <chrono>
+#include <condition_variable>
+#include <cstddef>
+#include <cstdint>
+#include <functional>
+#include <list>
+#include <map>
+#include <memory>
+#include <mutex>
+#include <optional>
+#include <thread>
+#include <utility>
+#include <vector>
+
+#include <dpp/dpp.h>
+
+#include "logger/logger_factory.h"
+
+// Starts handler coroutines under a budget of in-flight work per event class, so a storm in one
+// class cannot take CPU and REST capacity from the others. Commands and messages are always
+// queued. Presence updates are coalesced per key, keeping only the latest update of each user, and
+// the oldest are shed once the queue is over its bound, whether they were submitted with a key or not. A single dispatcher thread starts the
+// coroutines; they continue on DPP's threads whenever an awaited REST call completes. Work can be
+// submitted for later, in which case the dispatcher queues it once it is due, so a delay runs the
+// same whether or not the gateway is connected.
+class AdmissionController final {
+public:
+  enum class EventClass {
+    kCommand,
+    kMessage,
+    kPresence
+  };
+
+  using Key = std::pair<uint64_t, uint64_t>;
+  // Move-only, so work can own the compact event it was extracted with.
+  using Work = std::move_only_function<dpp::task<void>()>;
+  // Called instead of the work when it is shed or submitted after Close, outside the controller's
+  // lock, so whoever submitted it can undo what it set up for it.
+  using Dropped = std::move_only_function<void()>;
+
+  struct Stats {
+    uint64_t admitted{};
+    uint64_t coalesced{};
+    uint64_t shed{};
+    std::size_t queued{};
+    std::size_t in_flight{};
+  };
+
+  AdmissionController() = delete;
+  ~AdmissionController();
+
+  AdmissionController(std::size_t command_concurrency, std::size_t message_concurrency, std::size_t presence_concurrency, std::size_t presence_queue_limit);
+
+  void Submit(EventClass event_class, Work work, Dropped dropped = {});
+  void Submit(EventClass event_class, Key key, Work work);
+  // Work not yet due when the controller is closed is dropped.
+  void Submit(EventClass event_class, std::chrono::steady_clock::time_point due, Work work, Dropped dropped = {});
+
+  void Close() noexcept;
+  void WaitIdle() noexcept;
+  std::size_t Drain(std::chrono::steady_clock::time_point deadline) noexcept;
+
+  Stats GetStats(EventClass event_class) const noexcept;
+
+private:
+  static constexpr std::size_t kEventClasses = 3;
+
+  struct Item {
+    std::optional<Key> key;
+    Work work;
+    Dropped dropped;
+  };
+
+  struct Lane {
+    std::size_t concurrency{};
+    std::size_t queue_limit{};
+    std::list<Item> queue;
+    std::map<Key, std::list<Item>::iterator> queued_keys;
+    Stats stats;
+
+    // Returns the item shed from the front, if the queue was over its limit.
+    std::optional<Item> ShedOverLimit() noexcept;
+  };
+
+  // Shared with running coroutines, so one resumed while the controller is being destroyed can
+  // still update its lane. Coroutines abandoned at the drain deadline reference the handlers'
+  // owners too, so those owners must stop REST completions before they are destroyed; see
+  // Rest::Close.
+  struct State {
+    std::mutex mutex;
+    std::condition_variable work_condition;
+    std::condition_variable idle_condition;
+    std::array<Lane, kEventClasses> lanes;
+    // Work submitted for later with its lane, by due time.
+    std::multimap<std::chrono::steady_clock::time_point, std::pair<std::size_t, Item>> delayed;
+    bool closed{};
+    bool stopping{};
+
+    std::size_t GetPendingWork() const noexcept;
+  };
+
+  static void NotifyDropped(std::optional<Item> item) noexcept;
+  // Queues the delayed work that is due, returning the items shed to make room for it.
+  std::vector<std::optional<Item>> QueueDueWork() noexcept;
+  static dpp::job Execute(std::shared_ptr<State> state, std::size_t lane_index, Work work);
+  void Run();
+
+private:
+  Logger const logger_ = LoggerFactory::Get().Create("Admission Controller");
+
+  std::shared_ptr<State> const state_ = std::make_shared<State>();
+  std::thread dispatcher_;
+};
\ No newline at end of file
@@ -0,0 +1,143 @@
+#include "user_throttle.h"
+
+#include <algorithm>
+#include <utility>
+
+namespace {
+  std::size_t HashUserId(uint64_t const user_id) noexcept {
+    // Snowflakes from the same millisecond differ only in their low bits, so they are mixed before
+    // being masked down to a slot.
+    auto const mixed = user_id * 0x9E3779B97F4A7C15ULL;
+    return static_cast<std::size_t>(mixed ^ (mixed >> 32));
+  }
+}
+
+UserThrottle::UserThrottle(Settings::ThrottleSettings const& settings) noexcept {
+  auto const rates = std::array<Settings::ThrottleRate, kActions>{settings.streaming_messages, settings.clip_links, settings.reactions};
+  for (std::size_t action_index = 0; action_index < kActions; ++action_index) {
+    auto const& rate = rates[action_index];
+    if (rate.per_minute > 0.0) {
+      buckets_[action_index] = Bucket{.tokens_per_millisecond = rate.per_minute / 60000.0, .burst = static_cast<float>(std::max(rate.burst, 1.0))};
+    }
+  }
+}
+
+bool UserThrottle::TryAcquire(Action const action, dpp::snowflake const user_id) noexcept {
+  auto const action_index = static_cast<std::size_t>(action);
+  std::scoped_lock<std::mutex> const mutex_lock(mutex_);
+
+  auto& stats = stats_[action_index];
+  if (0.0 == buckets_[action_index].tokens_per_millisecond) {
+    ++stats.allowed;
+    return true;
+  }
+
+  auto const now_milliseconds = GetNowMilliseconds();
+  auto& slot = FindOrInsert(static_cast<uint64_t>(user_id), now_milliseconds);
+  Refill(slot, now_milliseconds);
+
+  auto& tokens = slot.tokens[action_index];
+  if (tokens < 1.0F) {
+    ++stats.throttled;
+    return false;
+  }
+
+  tokens -= 1.0F;
+  ++stats.allowed;
+  return true;
+}
+
+UserThrottle::Stats UserThrottle::GetStats(Action const action) const noexcept {
+  std::scoped_lock<std::mutex> const mutex_lock(mutex_);
+  return stats_[static_cast<std::size_t>(action)];
+}
+
+std::size_t UserThrottle::GetUserCount() const noexcept {
+  std::scoped_lock<std::mutex> const mutex_lock(mutex_);
+  return users_;
+}
+
+int64_t UserThrottle::GetNowMilliseconds() const noexcept {
+  return std::chrono::duration_cast<std::chrono::milliseconds>(std::chrono::steady_clock::now() - start_).count();
+}
+
+void UserThrottle::Refill(Slot& slot, int64_t const now_milliseconds) const noexcept {
+  auto const elapsed_milliseconds = static_cast<double>(now_milliseconds - slot.refill_milliseconds);
+  if (elapsed_milliseconds <= 0.0) {
+    return;
+  }
+
+  for (std::size_t action_index = 0; action_index < kActions; ++action_index) {
+    auto const& bucket = buckets_[action_index];
+    slot.tokens[action_index] = static_cast<float>(std::min<double>(bucket.burst, slot.tokens[action_index] + (elapsed_milliseconds * bucket.tokens_per_millisecond)));
+  }
+  slot.refill_milliseconds = now_milliseconds;
+}
+
+bool UserThrottle::IsFull(Slot const& slot) const noexcept {
+  for (std::size_t action_index = 0; action_index < kActions; ++action_index) {
+    if (slot.tokens[action_index] < buckets_[action_index].burst) {
+      return false;
+    }
+  }
+  return true;
+}
+
+UserThrottle::Slot& UserThrottle::FindOrInsert(uint64_t const user_id, int64_t const now_milliseconds) {
+  auto const probe = [this](uint64_t const probed_user_id) -> Slot& {
+    auto const mask = slots_.size() - 1;
+    for (auto slot_index = ::HashUserId(probed_user_id) & mask;; slot_index = (slot_index + 1) & mask) {
+      auto& slot = slots_[slot_index];
+      if ((probed_user_id == slot.user_id) || (0 == slot.user_id)) {
+        return slot;
+      }
+    }
+  };
+
+  auto* slot = &probe(user_id);
+  if (user_id == slot->user_id) {
+    return *slot;
+  }
+
+  // Kept at most three quarters full. Users with full buckets are in the same state as ones never
+  // seen, so they are dropped first and the table only grows when that is not enough.
+  if ((4 * (users_ + 1)) > (3 * slots_.size())) {
+    Rebuild(slots_.size(), now_milliseconds);
+    if ((2 * users_) >= slots_.size()) {
+      Rebuild(2 * slots_.size(), now_milliseconds);
+    }
+    slot = &probe(user_id);
+  }
+
+  slot->user_id = user_id;
+  slot->refill_milliseconds = now_milliseconds;
+  for (std::size_t action_index = 0; action_index < kActions; ++action_index) {
+    slot->tokens[action_index] = buckets_[action_index].burst;
+  }
+  ++users_;
+  return *slot;
+}
+
+void UserThrottle::Rebuild(std::size_t const capacity, int64_t const now_milliseconds) {
+  auto old_slots = std::exchange(slots_, std::vector<Slot>(capacity));
+  users_ = 0;
+
+  auto const mask = capacity - 1;
+  for (auto& old_slot : old_slots) {
+    if (0 == old_slot.user_id) {
+      continue;
+    }
+
+    Refill(old_slot, now_milliseconds);
+    if (IsFull(old_slot)) {
+      continue;
+    }
+
+    auto slot_index = ::HashUserId(old_slot.user_id) & mask;
+    while (0 != slots_[slot_index].user_id) {
+      slot_index = (slot_index + 1) & mask;
+    }
+    slots_[slot_index] = old_slot;
+    ++users_;
+  }
+}
\ No newline at end of file
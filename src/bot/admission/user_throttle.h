@@ -0,0 +1,71 @@
+#pragma once
+
+#include <array>
+#include <chrono>
+#include <cstddef>
+#include <cstdint>
+#include <mutex>
+#include <vector>
+
+#include <dpp/dpp.h>
+
+#include "settings/settings.h"
+
+// Token buckets per user for the actions a user can make the bot spend REST calls on, so one user
+// cannot use up the bot's global rate limit. Each user takes one 32-byte slot in an open-addressing
+// table keyed by their snowflake, holding a bucket per action refilled from a shared timestamp.
+// Users whose buckets have all refilled are dropped whenever the table would otherwise grow.
+class UserThrottle final {
+public:
+  enum class Action {
+    kStreamingMessage,
+    kClipLink,
+    kReaction
+  };
+
+  struct Stats {
+    uint64_t allowed{};
+    uint64_t throttled{};
+  };
+
+  UserThrottle() = delete;
+  ~UserThrottle() = default;
+
+  UserThrottle(Settings::ThrottleSettings const& settings) noexcept;
+
+  // Takes a token from the user's bucket for the action, or returns false when it is empty.
+  bool TryAcquire(Action action, dpp::snowflake user_id) noexcept;
+
+  Stats GetStats(Action action) const noexcept;
+  std::size_t GetUserCount() const noexcept;
+
+private:
+  static constexpr std::size_t kActions = 3;
+  static constexpr std::size_t kInitialCapacity = 256;
+
+  struct Bucket {
+    double tokens_per_millisecond{};
+    float burst{};
+  };
+
+  struct Slot {
+    uint64_t user_id{};
+    int64_t refill_milliseconds{};
+    std::array<float, kActions> tokens{};
+  };
+
+  int64_t GetNowMilliseconds() const noexcept;
+  void Refill(Slot& slot, int64_t now_milliseconds) const noexcept;
+  bool IsFull(Slot const& slot) const noexcept;
+  Slot& FindOrInsert(uint64_t user_id, int64_t now_milliseconds);
+  void Rebuild(std::size_t capacity, int64_t now_milliseconds);
+
+private:
+  std::chrono::steady_clock::time_point const start_ = std::chrono::steady_clock::now();
+  std::array<Bucket, kActions> buckets_{};
+
+  mutable std::mutex mutex_;
+  std::vector<Slot> slots_ = std::vector<Slot>(kInitialCapacity);
+  std::size_t users_{};
+  std::array<Stats, kActions> stats_{};
+};
\ No newline at end of file
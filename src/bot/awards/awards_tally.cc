@@ -0,0 +1,144 @@
+#include "awards_tally.h"
+
+#include <algorithm>
+#include <chrono>
+#include <format>
+#include <iterator>
+#include <ranges>
+#include <string_view>
+
+#include <nlohmann/json.hpp>
+
+#include "clip/clip_url.h"
+
+namespace {
+  std::string QuoteCsv(std::string_view const field) {
+    std::string quoted_field("\"");
+    for (auto const character : field) {
+      quoted_field.append(('"' == character) ? "\"\"" : std::string(1, character));
+    }
+    return quoted_field.append("\"");
+  }
+}
+
+AwardsTally::AwardsTally(std::string const& log_path) :
+  log_path_(log_path) {
+  auto const [replayed_nominations, last_line_terminated] = Replay();
+  logger_.Info("Replayed {} awards nominations from '{}'", replayed_nominations, log_path_);
+
+  log_.open(log_path_, std::ios::app);
+  if (!log_) {
+    logger_.Error("Failed to open awards log '{}', new nominations will only be kept until restart", log_path_);
+  } else if (!last_line_terminated) {
+    log_ << '\n';
+  }
+}
+
+void AwardsTally::CatchUp() noexcept {
+  std::scoped_lock<std::mutex> const mutex_lock(mutex_);
+  auto const [replayed_nominations, last_line_terminated] = Replay();
+  if (!last_line_terminated && log_) {
+    log_ << '\n' << std::flush;
+  }
+  logger_.Info("Caught up on {} awards nominations from '{}'", replayed_nominations, log_path_);
+}
+
+bool AwardsTally::Record(dpp::snowflake const guild_id, dpp::snowflake const user_id, std::string const& category, std::string const& clip_url) noexcept {
+  std::scoped_lock<std::mutex> const mutex_lock(mutex_);
+  if (!Apply(guild_id, user_id, category, clip_url)) {
+    return false;
+  }
+
+  auto const nomination_json = nlohmann::json{
+    {"guild_id", static_cast<uint64_t>(guild_id)},
+    {"user_id", static_cast<uint64_t>(user_id)},
+    {"category", category},
+    {"clip_url", clip_url},
+    {"at", std::chrono::duration_cast<std::chrono::seconds>(std::chrono::system_clock::now().time_since_epoch()).count()}
+  };
+  log_ << nomination_json.dump() << '\n' << std::flush;
+  if (!log_) {
+    logger_.Error("Failed to append nomination of '{}' in category '{}' to the awards log", clip_url, category);
+  }
+
+  return true;
+}
+
+std::vector<std::string> AwardsTally::GetCategories(dpp::snowflake const guild_id) const noexcept {
+  std::scoped_lock<std::mutex> const mutex_lock(mutex_);
+
+  std::vector<std::string> categories;
+  auto const it_guild = guilds_.find(guild_id);
+  if (guilds_.cend() != it_guild) {
+    std::ranges::transform(it_guild->second.categories, std::back_inserter(categories), [](auto const& name_and_category) { return name_and_category.first; });
+  }
+  return categories;
+}
+
+std::vector<AwardsTally::Entry> AwardsTally::GetLatestNominations(dpp::snowflake const guild_id, std::string const& category, std::size_t const limit) const noexcept {
+  std::scoped_lock<std::mutex> const mutex_lock(mutex_);
+
+  std::vector<Entry> latest_nominations;
+  auto const it_guild = guilds_.find(guild_id);
+  if (guilds_.cend() == it_guild) {
+    return latest_nominations;
+  }
+
+  auto const it_category = it_guild->second.categories.find(category);
+  if (it_guild->second.categories.cend() == it_category) {
+    return latest_nominations;
+  }
+
+  std::ranges::copy(it_category->second | std::views::reverse | std::views::take(limit), std::back_inserter(latest_nominations));
+  return latest_nominations;
+}
+
+std::string AwardsTally::Export(dpp::snowflake const guild_id) const noexcept {
+  std::scoped_lock<std::mutex> const mutex_lock(mutex_);
+
+  std::string tally("categoria,clipe,membro\n");
+  auto const it_guild = guilds_.find(guild_id);
+  if (guilds_.cend() == it_guild) {
+    return tally;
+  }
+
+  for (auto const& [name, entries] : it_guild->second.categories) {
+    for (auto const& entry : entries) {
+      tally.append(std::format("{},{},{}\n", ::QuoteCsv(name), ::QuoteCsv(entry.clip_url), entry.user_id.str()));
+    }
+  }
+
+  return tally;
+}
+
+std::pair<std::size_t, bool> AwardsTally::Replay() {
+  std::size_t replayed_nominations{};
+  auto last_line_terminated = true;
+  std::ifstream log_file(log_path_);
+  log_file.seekg(replayed_bytes_);
+  for (std::string line; std::getline(log_file, line);) {
+    last_line_terminated = !log_file.eof();
+    if (last_line_terminated) {
+      replayed_bytes_ += static_cast<std::streamoff>(line.size() + 1);
+    }
+
+    try {
+      auto const nomination_json = nlohmann::json::parse(line);
+      replayed_nominations += Apply(dpp::snowflake(nomination_json["guild_id"].get<uint64_t>()), dpp::snowflake(nomination_json["user_id"].get<uint64_t>()),
+                                    nomination_json["category"].get<std::string>(), nomination_json["clip_url"].get<std::string>()) ? 1 : 0;
+    } catch (nlohmann::json::exception const& json_exception) {
+      logger_.Warn("Skipping unreadable awards log line '{}'. Exception: '{}'", line, json_exception.what());
+    }
+  }
+  return {replayed_nominations, last_line_terminated};
+}
+
+bool AwardsTally::Apply(dpp::snowflake const guild_id, dpp::snowflake const user_id, std::string const& category, std::string const& clip_url) {
+  auto& guild = guilds_[guild_id];
+  if (!guild.nominations.emplace(user_id, ClipUrl::Canonicalize(clip_url)).second) {
+    return false;
+  }
+
+  guild.categories[category].push_back(Entry{.clip_url = clip_url, .user_id = user_id});
+  return true;
+}
\ No newline at end of file
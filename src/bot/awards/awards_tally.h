@@ -0,0 +1,61 @@
+#pragma once
+
+#include <cstddef>
+#include <cstdint>
+#include <fstream>
+#include <map>
+#include <mutex>
+#include <set>
+#include <string>
+#include <utility>
+#include <vector>
+
+#include <dpp/dpp.h>
+
+#include "logger/logger_factory.h"
+
+// Accepted awards nominations per guild and category, in the order they were made. Every
+// nomination is appended to a log of JSON lines that is replayed on start, so listing them needs
+// no message fetching. Only the member who posted a clip gets its nomination DM and a member
+// nominates a clip at most once, so each clip is nominated once and the tally lists clips rather
+// than ranking them.
+class AwardsTally final {
+public:
+  struct Entry {
+    std::string clip_url;
+    dpp::snowflake user_id;
+  };
+
+  AwardsTally() = delete;
+  ~AwardsTally() = default;
+
+  AwardsTally(std::string const& log_path);
+
+  bool Record(dpp::snowflake guild_id, dpp::snowflake user_id, std::string const& category, std::string const& clip_url) noexcept;
+
+  // Applies the nominations another instance appended to the log since it was last read.
+  void CatchUp() noexcept;
+
+  std::vector<std::string> GetCategories(dpp::snowflake guild_id) const noexcept;
+  // Returns the category's latest nominations, newest first.
+  std::vector<Entry> GetLatestNominations(dpp::snowflake guild_id, std::string const& category, std::size_t limit) const noexcept;
+  std::string Export(dpp::snowflake guild_id) const noexcept;
+
+private:
+  struct Guild {
+    std::map<std::string, std::vector<Entry>> categories;
+    std::set<std::pair<dpp::snowflake, std::string>> nominations;
+  };
+
+  std::pair<std::size_t, bool> Replay();
+  bool Apply(dpp::snowflake guild_id, dpp::snowflake user_id, std::string const& category, std::string const& clip_url);
+
+private:
+  Logger const logger_ = LoggerFactory::Get().Create("Awards Tally");
+
+  std::string const log_path_;
+  std::streamoff replayed_bytes_{};
+  std::map<dpp::snowflake, Guild> guilds_;
+  std::ofstream log_;
+  mutable std::mutex mutex_;
+};
\ No newline at end of file
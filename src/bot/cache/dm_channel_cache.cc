@@ -0,0 +1,96 @@
+#include "dm_channel_cache.h"
+
+#include <nlohmann/json.hpp>
+
+DmChannelCache::DmChannelCache(std::string const& log_path) :
+  log_path_(log_path) {
+  auto const last_line_terminated = Replay();
+  logger_.Info("Loaded {} DM channels from '{}'", users_ids_and_channels_ids_.size(), log_path_);
+
+  log_.open(log_path_, std::ios::app);
+  if (!log_) {
+    logger_.Error("Failed to open DM channel log '{}', new DM channels will only be cached until restart", log_path_);
+  } else if (!last_line_terminated) {
+    log_ << '\n';
+  }
+}
+
+void DmChannelCache::CatchUp() noexcept {
+  std::scoped_lock<std::mutex> const mutex_lock(mutex_);
+  if (!Replay() && log_) {
+    log_ << '\n' << std::flush;
+  }
+  logger_.Info("Caught up to {} DM channels from '{}'", users_ids_and_channels_ids_.size(), log_path_);
+}
+
+std::optional<dpp::snowflake> DmChannelCache::Find(dpp::snowflake const user_id) noexcept {
+  std::scoped_lock<std::mutex> const mutex_lock(mutex_);
+  auto const it_channel_id = users_ids_and_channels_ids_.find(user_id);
+  if (users_ids_and_channels_ids_.cend() == it_channel_id) {
+    ++misses_;
+    return std::nullopt;
+  }
+
+  ++hits_;
+  return it_channel_id->second;
+}
+
+void DmChannelCache::Insert(dpp::snowflake const user_id, dpp::snowflake const channel_id) noexcept {
+  std::scoped_lock<std::mutex> const mutex_lock(mutex_);
+  auto const [it_channel_id, inserted] = users_ids_and_channels_ids_.try_emplace(user_id, channel_id);
+  if (!inserted && (it_channel_id->second == channel_id)) {
+    return;
+  }
+
+  it_channel_id->second = channel_id;
+  Append(user_id, channel_id);
+}
+
+void DmChannelCache::Erase(dpp::snowflake const user_id) noexcept {
+  std::scoped_lock<std::mutex> const mutex_lock(mutex_);
+  if (0 != users_ids_and_channels_ids_.erase(user_id)) {
+    Append(user_id, dpp::snowflake{});
+  }
+}
+
+DmChannelCache::Stats DmChannelCache::GetStats() const noexcept {
+  std::scoped_lock<std::mutex> const mutex_lock(mutex_);
+  return Stats{.entries = users_ids_and_channels_ids_.size(), .hits = hits_, .misses = misses_};
+}
+
+bool DmChannelCache::Replay() {
+  auto last_line_terminated = true;
+  std::ifstream log_file(log_path_);
+  log_file.seekg(replayed_bytes_);
+  for (std::string line; std::getline(log_file, line);) {
+    last_line_terminated = !log_file.eof();
+    if (last_line_terminated) {
+      replayed_bytes_ += static_cast<std::streamoff>(line.size() + 1);
+    }
+
+    try {
+      auto const dm_channel_json = nlohmann::json::parse(line);
+      auto const user_id = dpp::snowflake(dm_channel_json["user_id"].get<uint64_t>());
+      auto const channel_id = dpp::snowflake(dm_channel_json["channel_id"].get<uint64_t>());
+      if (channel_id.empty()) {
+        users_ids_and_channels_ids_.erase(user_id);
+      } else {
+        users_ids_and_channels_ids_.insert_or_assign(user_id, channel_id);
+      }
+    } catch (nlohmann::json::exception const& json_exception) {
+      logger_.Warn("Skipping unreadable DM channel log line '{}'. Exception: '{}'", line, json_exception.what());
+    }
+  }
+  return last_line_terminated;
+}
+
+void DmChannelCache::Append(dpp::snowflake const user_id, dpp::snowflake const channel_id) noexcept {
+  auto const dm_channel_json = nlohmann::json{
+    {"user_id", static_cast<uint64_t>(user_id)},
+    {"channel_id", static_cast<uint64_t>(channel_id)}
+  };
+  log_ << dm_channel_json.dump() << '\n' << std::flush;
+  if (!log_) {
+    logger_.Error("Failed to append DM channel of user '{}' to the DM channel log", user_id.str());
+  }
+}
\ No newline at end of file
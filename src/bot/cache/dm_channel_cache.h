@@ -0,0 +1,53 @@
+#pragma once
+
+#include <cstddef>
+#include <fstream>
+#include <mutex>
+#include <optional>
+#include <string>
+#include <unordered_map>
+
+#include <dpp/dpp.h>
+
+#include "logger/logger_factory.h"
+
+// DM channel of every user the bot has written to. DPP only remembers these for the life of the
+// process, so the first DM to each user after a restart had to open the channel again. Changes are
+// appended to a log of JSON lines that is replayed on start.
+class DmChannelCache final {
+public:
+  struct Stats {
+    std::size_t entries{};
+    std::size_t hits{};
+    std::size_t misses{};
+  };
+
+  DmChannelCache() = delete;
+  ~DmChannelCache() = default;
+
+  DmChannelCache(std::string const& log_path);
+
+  std::optional<dpp::snowflake> Find(dpp::snowflake user_id) noexcept;
+  void Insert(dpp::snowflake user_id, dpp::snowflake channel_id) noexcept;
+  void Erase(dpp::snowflake user_id) noexcept;
+
+  // Applies the channels another instance appended to the log since it was last read.
+  void CatchUp() noexcept;
+
+  Stats GetStats() const noexcept;
+
+private:
+  bool Replay();
+  void Append(dpp::snowflake user_id, dpp::snowflake channel_id) noexcept;
+
+private:
+  Logger const logger_ = LoggerFactory::Get().Create("DM Channel Cache");
+
+  std::string const log_path_;
+  std::streamoff replayed_bytes_{};
+  std::unordered_map<dpp::snowflake, dpp::snowflake> users_ids_and_channels_ids_;
+  std::ofstream log_;
+  std::size_t hits_{};
+  std::size_t misses_{};
+  mutable std::mutex mutex_;
+};
\ No newline at end of file
@@ -0,0 +1,122 @@
+#include "user_cache_budget.h"
+
+#include <shared_mutex>
+#include <vector>
+
+UserCacheBudget::UserCacheBudget(std::size_t const budget_bytes) noexcept :
+  budget_bytes_(budget_bytes) {
+
+}
+
+void UserCacheBudget::Touch(dpp::snowflake const user_id) noexcept {
+  if (0 == budget_bytes_) {
+    return;
+  }
+
+  std::scoped_lock<std::mutex> const mutex_lock(mutex_);
+  auto const it_position = recent_users_positions_.find(user_id);
+  if (recent_users_positions_.cend() != it_position) {
+    recent_users_ids_.splice(recent_users_ids_.begin(), recent_users_ids_, it_position->second);
+    return;
+  }
+
+  recent_users_ids_.push_front(user_id);
+  recent_users_positions_.emplace(user_id, recent_users_ids_.begin());
+}
+
+void UserCacheBudget::Pin(dpp::snowflake const user_id) noexcept {
+  std::scoped_lock<std::mutex> const mutex_lock(mutex_);
+  pinned_users_ids_.insert(user_id);
+}
+
+void UserCacheBudget::Unpin(dpp::snowflake const user_id) noexcept {
+  std::scoped_lock<std::mutex> const mutex_lock(mutex_);
+  pinned_users_ids_.erase(user_id);
+}
+
+UserCacheBudget::Stats UserCacheBudget::Trim() noexcept {
+  // DPP's cache is only read under its own lock, and users are removed after it is released, as
+  // removing one takes that lock too.
+  std::unordered_map<dpp::snowflake, std::size_t> cached_users_bytes;
+  Stats stats;
+  auto* const user_cache = dpp::get_user_cache();
+  {
+    std::shared_lock<std::shared_mutex> const cache_lock(user_cache->get_mutex());
+    for (auto const& [user_id, user] : user_cache->get_container()) {
+      auto const user_bytes = EstimateBytes(*user);
+      cached_users_bytes.emplace(user_id, user_bytes);
+      stats.bytes += user_bytes;
+    }
+  }
+
+  std::vector<dpp::snowflake> evicted_users_ids;
+  {
+    std::scoped_lock<std::mutex> const mutex_lock(mutex_);
+
+    // Users that left the cache no longer need a place in the recency order.
+    for (auto it_user_id = recent_users_ids_.begin(); recent_users_ids_.end() != it_user_id;) {
+      if (cached_users_bytes.contains(*it_user_id)) {
+        ++it_user_id;
+        continue;
+      }
+      recent_users_positions_.erase(*it_user_id);
+      it_user_id = recent_users_ids_.erase(it_user_id);
+    }
+
+    auto const evict = [this, &cached_users_bytes, &evicted_users_ids, &stats](dpp::snowflake const user_id) {
+      if ((stats.bytes <= budget_bytes_) || pinned_users_ids_.contains(user_id)) {
+        return;
+      }
+      stats.bytes -= cached_users_bytes.at(user_id);
+      evicted_users_ids.push_back(user_id);
+    };
+
+    if ((0 != budget_bytes_) && (stats.bytes > budget_bytes_)) {
+      for (auto const& [user_id, user_bytes] : cached_users_bytes) {
+        if (!recent_users_positions_.contains(user_id)) {
+          evict(user_id);
+        }
+      }
+      for (auto it_user_id = recent_users_ids_.rbegin(); recent_users_ids_.rend() != it_user_id; ++it_user_id) {
+        evict(*it_user_id);
+      }
+    }
+
+    for (auto const user_id : evicted_users_ids) {
+      auto const it_position = recent_users_positions_.find(user_id);
+      if (recent_users_positions_.cend() != it_position) {
+        recent_users_ids_.erase(it_position->second);
+        recent_users_positions_.erase(it_position);
+      }
+    }
+
+    stats.users = cached_users_bytes.size() - evicted_users_ids.size();
+    stats.pinned = pinned_users_ids_.size();
+    stats.evicted = stats_.evicted + evicted_users_ids.size();
+    stats_ = stats;
+  }
+
+  for (auto const user_id : evicted_users_ids) {
+    if (auto* const user = dpp::find_user(user_id)) {
+      user_cache->remove(user);
+    }
+  }
+
+  if (!evicted_users_ids.empty()) {
+    logger_.Info("Removed {} users from DPP's user cache to fit {} KiB", evicted_users_ids.size(), budget_bytes_ / 1024);
+  }
+  return stats;
+}
+
+UserCacheBudget::Stats UserCacheBudget::GetStats() const noexcept {
+  std::scoped_lock<std::mutex> const mutex_lock(mutex_);
+  return stats_;
+}
+
+std::size_t UserCacheBudget::GetBudgetBytes() const noexcept {
+  return budget_bytes_;
+}
+
+std::size_t UserCacheBudget::EstimateBytes(dpp::user const& user) noexcept {
+  return sizeof(dpp::user) + user.username.capacity();
+}
\ No newline at end of file
@@ -0,0 +1,59 @@
+#pragma once
+
+#include <cstddef>
+#include <cstdint>
+#include <list>
+#include <mutex>
+#include <set>
+#include <unordered_map>
+
+#include <dpp/dpp.h>
+
+#include "logger/logger_factory.h"
+
+// Byte budget for DPP's user cache, which otherwise keeps every user it sees for as long as the
+// process runs. Handlers report the users they see, and once the cached users are estimated to
+// pass the budget, Trim removes the least recently seen ones, starting with users no handler ever
+// saw. Moderators and active streamers are pinned and never removed. No handler reads users from
+// DPP's cache, so removing them costs no correctness.
+class UserCacheBudget final {
+public:
+  struct Stats {
+    std::size_t users{};
+    std::size_t bytes{};
+    std::size_t pinned{};
+    uint64_t evicted{};
+  };
+
+  UserCacheBudget() = delete;
+  ~UserCacheBudget() = default;
+
+  // A budget of 0 leaves the cache unbounded.
+  UserCacheBudget(std::size_t budget_bytes) noexcept;
+
+  void Touch(dpp::snowflake user_id) noexcept;
+  void Pin(dpp::snowflake user_id) noexcept;
+  void Unpin(dpp::snowflake user_id) noexcept;
+
+  // Returns the cache's size once trimmed.
+  Stats Trim() noexcept;
+
+  // Returns the cache's size as of the last trim.
+  Stats GetStats() const noexcept;
+  std::size_t GetBudgetBytes() const noexcept;
+
+private:
+  static std::size_t EstimateBytes(dpp::user const& user) noexcept;
+
+private:
+  Logger const logger_ = LoggerFactory::Get().Create("User Cache Budget");
+
+  std::size_t const budget_bytes_;
+
+  mutable std::mutex mutex_;
+  // Most recently seen first.
+  std::list<dpp::snowflake> recent_users_ids_;
+  std::unordered_map<dpp::snowflake, std::list<dpp::snowflake>::iterator> recent_users_positions_;
+  std::set<dpp::snowflake> pinned_users_ids_;
+  Stats stats_;
+};
\ No newline at end of file
@@ -0,0 +1,298 @@
+#include "clip_index.h"
+
+#include <bit>
+#include <cstdio>
+#include <utility>
+
+#include <fcntl.h>
+#include <sys/mman.h>
+#include <sys/stat.h>
+#include <unistd.h>
+
+namespace {
+  auto constexpr kMagic = 0x5844494c50494c43ULL;
+  auto constexpr kVersion = 1U;
+  auto constexpr kHeaderWords = std::size_t{4};
+  auto constexpr kMinCapacity = std::size_t{64};
+  auto constexpr kMaxLoadPercent = 70U;
+  auto constexpr kBloomBitsPerSlot = std::size_t{16};
+  auto constexpr kBloomHashes = 6U;
+
+  uint64_t Mix(uint64_t value) {
+    value ^= value >> 30;
+    value *= 0xbf58476d1ce4e5b9ULL;
+    value ^= value >> 27;
+    value *= 0x94d049bb133111ebULL;
+    value ^= value >> 31;
+    return value;
+  }
+
+  // Stable across runs and builds, unlike std::hash, since fingerprints are stored on disk. Zero
+  // marks an empty slot, so it is never returned.
+  uint64_t Fingerprint(dpp::snowflake const guild_id, std::string_view const canonical_url) {
+    auto hash = 0xcbf29ce484222325ULL ^ ::Mix(static_cast<uint64_t>(guild_id));
+    for (auto const character : canonical_url) {
+      hash ^= static_cast<unsigned char>(character);
+      hash *= 0x100000001b3ULL;
+    }
+
+    hash = ::Mix(hash);
+    return (0 != hash) ? hash : 1;
+  }
+
+  std::size_t GetMappingBytes(std::size_t const capacity) {
+    return sizeof(uint64_t) * (kHeaderWords + capacity);
+  }
+}
+
+ClipIndex::ClipIndex(std::string path, std::size_t const initial_capacity) :
+  path_(std::move(path)) {
+  auto const capacity = std::bit_ceil(std::max(initial_capacity, kMinCapacity));
+  auto mapping = MapFile(path_, capacity);
+  persistent_ = mapping.has_value();
+  if (!mapping) {
+    logger_.Error("Failed to map clip index '{}', nominated clips will only be remembered until restart", path_);
+    mapping = MapAnonymous(capacity);
+  }
+
+  if (mapping) {
+    mapping_ = *mapping;
+    RebuildBloomFilter();
+    if (persistent_) {
+      logger_.Info("Loaded {} nominated clips from '{}'", mapping_.header->entries, path_);
+    }
+  }
+}
+
+ClipIndex::~ClipIndex() {
+  if (nullptr != mapping_.address) {
+    if (persistent_) {
+      msync(mapping_.address, mapping_.bytes, MS_SYNC);
+    }
+    Unmap(mapping_);
+  }
+}
+
+bool ClipIndex::Insert(dpp::snowflake const guild_id, std::string_view const canonical_url) noexcept {
+  auto const fingerprint = ::Fingerprint(guild_id, canonical_url);
+
+  std::scoped_lock<std::mutex> const mutex_lock(mutex_);
+  if (nullptr == mapping_.address) {
+    return true;
+  }
+
+  ++stats_.lookups;
+  if (!MayContain(fingerprint)) {
+    ++stats_.bloom_rejections;
+  } else if (fingerprint == *Probe(mapping_, fingerprint)) {
+    ++stats_.duplicates;
+    return false;
+  }
+
+  Store(fingerprint);
+  return true;
+}
+
+void ClipIndex::Erase(dpp::snowflake const guild_id, std::string_view const canonical_url) noexcept {
+  auto const fingerprint = ::Fingerprint(guild_id, canonical_url);
+
+  std::scoped_lock<std::mutex> const mutex_lock(mutex_);
+  if ((nullptr == mapping_.address) || !MayContain(fingerprint)) {
+    return;
+  }
+
+  auto* const slot = Probe(mapping_, fingerprint);
+  if (fingerprint != *slot) {
+    return;
+  }
+
+  // Backward-shift deletion: every later fingerprint of the probe run that may sit in the hole
+  // without coming before its home slot is moved into it, so no lookup stops early at the hole.
+  auto const mask = mapping_.header->capacity - 1;
+  auto hole_index = static_cast<uint64_t>(slot - mapping_.slots);
+  for (auto slot_index = (hole_index + 1) & mask; 0 != mapping_.slots[slot_index]; slot_index = (slot_index + 1) & mask) {
+    auto const home_index = mapping_.slots[slot_index] & mask;
+    if (((slot_index - home_index) & mask) >= ((slot_index - hole_index) & mask)) {
+      mapping_.slots[hole_index] = mapping_.slots[slot_index];
+      hole_index = slot_index;
+    }
+  }
+
+  mapping_.slots[hole_index] = 0;
+  --mapping_.header->entries;
+}
+
+void ClipIndex::Reload() noexcept {
+  std::scoped_lock<std::mutex> const mutex_lock(mutex_);
+  if (!persistent_) {
+    return;
+  }
+
+  auto const mapping = MapFile(path_, mapping_.header->capacity);
+  if (!mapping) {
+    logger_.Error("Failed to map clip index '{}' again, keeping the current mapping", path_);
+    return;
+  }
+
+  Unmap(mapping_);
+  mapping_ = *mapping;
+  RebuildBloomFilter();
+  logger_.Info("Reloaded {} nominated clips from '{}'", mapping_.header->entries, path_);
+}
+
+ClipIndex::Stats ClipIndex::GetStats() const noexcept {
+  std::scoped_lock<std::mutex> const mutex_lock(mutex_);
+
+  auto stats = stats_;
+  if (nullptr != mapping_.address) {
+    stats.entries = mapping_.header->entries;
+    stats.capacity = mapping_.header->capacity;
+  }
+  return stats;
+}
+
+std::optional<ClipIndex::Mapping> ClipIndex::MapFile(std::string const& path, std::size_t const capacity) const noexcept {
+  static_assert(sizeof(Header) == kHeaderWords * sizeof(uint64_t));
+
+  auto const file_descriptor = open(path.c_str(), O_RDWR | O_CREAT, 0644);
+  if (-1 == file_descriptor) {
+    return std::nullopt;
+  }
+
+  struct stat file_stat{};
+  fstat(file_descriptor, &file_stat);
+  auto const file_bytes = static_cast<std::size_t>(file_stat.st_size);
+
+  Header existing_header;
+  auto const valid = (file_bytes >= sizeof(Header)) && (sizeof(Header) == pread(file_descriptor, &existing_header, sizeof(Header), 0)) &&
+                     (kMagic == existing_header.magic) && (kVersion == existing_header.version) && std::has_single_bit(existing_header.capacity) &&
+                     (file_bytes == ::GetMappingBytes(existing_header.capacity)) && (existing_header.entries < existing_header.capacity);
+  if (!valid && (0 != file_bytes)) {
+    logger_.Error("Clip index '{}' is corrupt or from another version, starting an empty index", path);
+  }
+
+  auto const mapping_capacity = valid ? static_cast<std::size_t>(existing_header.capacity) : capacity;
+  auto const mapping_bytes = ::GetMappingBytes(mapping_capacity);
+  if (!valid && ((0 != ftruncate(file_descriptor, 0)) || (0 != ftruncate(file_descriptor, static_cast<off_t>(mapping_bytes))))) {
+    close(file_descriptor);
+    return std::nullopt;
+  }
+
+  auto* const address = mmap(nullptr, mapping_bytes, PROT_READ | PROT_WRITE, MAP_SHARED, file_descriptor, 0);
+  close(file_descriptor);
+  if (MAP_FAILED == address) {
+    return std::nullopt;
+  }
+
+  auto mapping = Mapping{.address = address, .bytes = mapping_bytes, .header = static_cast<Header*>(address), .slots = static_cast<uint64_t*>(address) + kHeaderWords};
+  if (!valid) {
+    *mapping.header = Header{.magic = kMagic, .version = kVersion, .capacity = mapping_capacity, .entries = 0};
+  }
+
+  return mapping;
+}
+
+std::optional<ClipIndex::Mapping> ClipIndex::MapAnonymous(std::size_t const capacity) noexcept {
+  auto const mapping_bytes = ::GetMappingBytes(capacity);
+  auto* const address = mmap(nullptr, mapping_bytes, PROT_READ | PROT_WRITE, MAP_PRIVATE | MAP_ANONYMOUS, -1, 0);
+  if (MAP_FAILED == address) {
+    return std::nullopt;
+  }
+
+  auto mapping = Mapping{.address = address, .bytes = mapping_bytes, .header = static_cast<Header*>(address), .slots = static_cast<uint64_t*>(address) + kHeaderWords};
+  *mapping.header = Header{.magic = kMagic, .version = kVersion, .capacity = capacity, .entries = 0};
+  return mapping;
+}
+
+void ClipIndex::Unmap(Mapping const& mapping) noexcept {
+  munmap(mapping.address, mapping.bytes);
+}
+
+uint64_t* ClipIndex::Probe(Mapping const& mapping, uint64_t const fingerprint) noexcept {
+  auto const mask = mapping.header->capacity - 1;
+  auto slot_index = fingerprint & mask;
+  while ((0 != mapping.slots[slot_index]) && (fingerprint != mapping.slots[slot_index])) {
+    slot_index = (slot_index + 1) & mask;
+  }
+
+  return &mapping.slots[slot_index];
+}
+
+void ClipIndex::Store(uint64_t const fingerprint) noexcept {
+  if ((mapping_.header->entries + 1) * 100 > mapping_.header->capacity * kMaxLoadPercent) {
+    Grow();
+  }
+
+  if (mapping_.header->entries + 1 >= mapping_.header->capacity) {
+    logger_.Error("Clip index is full, clip will not be remembered");
+    return;
+  }
+
+  *Probe(mapping_, fingerprint) = fingerprint;
+  ++mapping_.header->entries;
+  AddToBloomFilter(fingerprint);
+}
+
+void ClipIndex::Grow() noexcept {
+  auto const capacity = static_cast<std::size_t>(mapping_.header->capacity) * 2;
+  auto const grown_path = path_ + ".grow";
+  std::remove(grown_path.c_str());
+
+  auto grown_mapping = persistent_ ? MapFile(grown_path, capacity) : MapAnonymous(capacity);
+  if (!grown_mapping) {
+    logger_.Error("Failed to grow clip index to {} slots", capacity);
+    return;
+  }
+
+  for (std::size_t slot_index = 0; slot_index < mapping_.header->capacity; ++slot_index) {
+    if (0 != mapping_.slots[slot_index]) {
+      *Probe(*grown_mapping, mapping_.slots[slot_index]) = mapping_.slots[slot_index];
+    }
+  }
+  grown_mapping->header->entries = mapping_.header->entries;
+
+  if (persistent_) {
+    msync(grown_mapping->address, grown_mapping->bytes, MS_SYNC);
+    if (0 != std::rename(grown_path.c_str(), path_.c_str())) {
+      logger_.Error("Failed to replace clip index '{}' with its grown copy", path_);
+      Unmap(*grown_mapping);
+      return;
+    }
+  }
+
+  Unmap(mapping_);
+  mapping_ = *grown_mapping;
+  RebuildBloomFilter();
+  logger_.Info("Grew clip index to {} slots", capacity);
+}
+
+void ClipIndex::RebuildBloomFilter() noexcept {
+  bloom_words_.assign(mapping_.header->capacity * kBloomBitsPerSlot / 64, 0);
+  for (std::size_t slot_index = 0; slot_index < mapping_.header->capacity; ++slot_index) {
+    if (0 != mapping_.slots[slot_index]) {
+      AddToBloomFilter(mapping_.slots[slot_index]);
+    }
+  }
+}
+
+void ClipIndex::AddToBloomFilter(uint64_t const fingerprint) noexcept {
+  auto const bits = bloom_words_.size() * 64;
+  auto const step = ::Mix(fingerprint) | 1;
+  for (auto hash_index = 0U; hash_index < kBloomHashes; ++hash_index) {
+    auto const bit = (fingerprint + hash_index * step) & (bits - 1);
+    bloom_words_[bit / 64] |= 1ULL << (bit % 64);
+  }
+}
+
+bool ClipIndex::MayContain(uint64_t const fingerprint) const noexcept {
+  auto const bits = bloom_words_.size() * 64;
+  auto const step = ::Mix(fingerprint) | 1;
+  for (auto hash_index = 0U; hash_index < kBloomHashes; ++hash_index) {
+    auto const bit = (fingerprint + hash_index * step) & (bits - 1);
+    if (0 == (bloom_words_[bit / 64] & (1ULL << (bit % 64)))) {
+      return false;
+    }
+  }
+
+  return true;
+}
\ No newline at end of file
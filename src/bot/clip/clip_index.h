@@ -0,0 +1,88 @@
+#pragma once
+
+#include <cstddef>
+#include <cstdint>
+#include <mutex>
+#include <optional>
+#include <string>
+#include <string_view>
+#include <vector>
+
+#include <dpp/dpp.h>
+
+#include "logger/logger_factory.h"
+
+// Persistent set of nominated clips, keyed by guild and canonical clip URL. The set is an open
+// addressing table of 64-bit fingerprints in a memory-mapped file, so it survives restarts without
+// a load step, and an in-memory Bloom filter answers for clips that were never seen without
+// touching the table. The table doubles by rebuilding into a new file that replaces the old one.
+// If the file cannot be mapped the index falls back to anonymous memory and only lasts the run.
+class ClipIndex final {
+public:
+  struct Stats {
+    std::size_t entries{};
+    std::size_t capacity{};
+    uint64_t lookups{};
+    uint64_t bloom_rejections{};
+    uint64_t duplicates{};
+  };
+
+  ClipIndex() = delete;
+  ~ClipIndex();
+
+  ClipIndex(std::string path, std::size_t initial_capacity);
+
+  ClipIndex(ClipIndex const&) = delete;
+  void operator=(ClipIndex const&) = delete;
+
+  // Returns false when the clip was already nominated in the guild, true after recording it.
+  bool Insert(dpp::snowflake guild_id, std::string_view canonical_url) noexcept;
+
+  // Forgets a clip recorded by Insert, so it can be nominated again. Its Bloom filter bits stay set,
+  // which only costs a table probe the next time it is looked up.
+  void Erase(dpp::snowflake guild_id, std::string_view canonical_url) noexcept;
+
+  // Maps the file again, picking up clips and growth from another instance sharing it.
+  void Reload() noexcept;
+
+  Stats GetStats() const noexcept;
+
+private:
+  struct Header {
+    uint64_t magic{};
+    uint32_t version{};
+    uint32_t reserved{};
+    uint64_t capacity{};
+    uint64_t entries{};
+  };
+
+  struct Mapping {
+    void* address{};
+    std::size_t bytes{};
+    Header* header{};
+    uint64_t* slots{};
+  };
+
+  std::optional<Mapping> MapFile(std::string const& path, std::size_t capacity) const noexcept;
+  static std::optional<Mapping> MapAnonymous(std::size_t capacity) noexcept;
+  static void Unmap(Mapping const& mapping) noexcept;
+
+  static uint64_t* Probe(Mapping const& mapping, uint64_t fingerprint) noexcept;
+  void Store(uint64_t fingerprint) noexcept;
+  void Grow() noexcept;
+
+  void RebuildBloomFilter() noexcept;
+  void AddToBloomFilter(uint64_t fingerprint) noexcept;
+  bool MayContain(uint64_t fingerprint) const noexcept;
+
+private:
+  Logger const logger_ = LoggerFactory::Get().Create("Clip Index");
+
+  std::string const path_;
+  bool persistent_{};
+  Mapping mapping_;
+  std::vector<uint64_t> bloom_words_;
+
+  Stats stats_;
+  mutable std::mutex mutex_;
+};
\ No newline at end of file
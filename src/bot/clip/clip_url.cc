@@ -0,0 +1,138 @@
+#include "clip_url.h"
+
+#include <algorithm>
+#include <array>
+#include <cctype>
+#include <iterator>
+#include <utility>
+#include <vector>
+
+namespace {
+  using Parameter = std::pair<std::string_view, std::string_view>;
+
+  auto constexpr kTrackingParameters = std::array<std::string_view, 10>{"si", "feature", "fbclid", "gclid", "igshid", "ref", "ref_src", "pp", "ab_channel", "tt_medium"};
+  auto constexpr kSignedHosts = std::array<std::string_view, 2>{"cdn.discordapp.com", "media.discordapp.net"};
+
+  std::string ToLower(std::string_view const text) {
+    std::string lower(text);
+    std::ranges::transform(lower, lower.begin(), [](unsigned char const character) { return static_cast<char>(std::tolower(character)); });
+    return lower;
+  }
+
+  std::string_view StripPrefix(std::string_view text, std::string_view const prefix) {
+    if (text.starts_with(prefix)) {
+      text.remove_prefix(prefix.size());
+    }
+    return text;
+  }
+
+  std::string_view GetSegment(std::string_view const path, std::size_t const index) {
+    std::size_t segment_start = 0;
+    for (std::size_t segment = 0; segment_start < path.size(); ++segment) {
+      while ((segment_start < path.size()) && ('/' == path[segment_start])) {
+        ++segment_start;
+      }
+      auto const segment_end = std::min(path.find('/', segment_start), path.size());
+      if (segment == index) {
+        return path.substr(segment_start, segment_end - segment_start);
+      }
+      segment_start = segment_end;
+    }
+
+    return {};
+  }
+
+  std::vector<Parameter> ParseQuery(std::string_view query) {
+    std::vector<Parameter> parameters;
+    while (!query.empty()) {
+      auto const parameter_end = std::min(query.find('&'), query.size());
+      auto const parameter = query.substr(0, parameter_end);
+      query.remove_prefix(std::min(parameter_end + 1, query.size()));
+      if (parameter.empty()) {
+        continue;
+      }
+
+      auto const value_start = parameter.find('=');
+      parameters.emplace_back(parameter.substr(0, value_start), (std::string_view::npos != value_start) ? parameter.substr(value_start + 1) : std::string_view());
+    }
+
+    return parameters;
+  }
+
+  std::string_view FindParameter(std::vector<Parameter> const& parameters, std::string_view const name) {
+    auto const it_parameter = std::ranges::find(parameters, name, &Parameter::first);
+    return (parameters.cend() != it_parameter) ? it_parameter->second : std::string_view();
+  }
+
+  std::string WithId(std::string_view const prefix, std::string_view const id) {
+    return id.empty() ? std::string() : std::string(prefix).append(id);
+  }
+
+  bool IsTracking(std::string_view const name) {
+    return name.starts_with("utm_") || (kTrackingParameters.cend() != std::ranges::find(kTrackingParameters, name));
+  }
+}
+
+std::string ClipUrl::Canonicalize(std::string_view url) {
+  url = url.substr(0, url.find('#'));
+  if (auto const scheme_end = url.find("://"); std::string_view::npos != scheme_end) {
+    url.remove_prefix(scheme_end + 3);
+  }
+
+  auto const path_start = std::min(url.find_first_of("/?"), url.size());
+  auto const query_start = std::min(url.find('?', path_start), url.size());
+  auto const host_lower = ::ToLower(url.substr(0, path_start));
+  auto const host = ::StripPrefix(::StripPrefix(host_lower, "www."), "m.");
+  auto path = url.substr(path_start, query_start - path_start);
+  while (path.ends_with('/')) {
+    path.remove_suffix(1);
+  }
+  auto const parameters = ::ParseQuery(url.substr(std::min(query_start + 1, url.size())));
+
+  if ("youtu.be" == host) {
+    return ::WithId("youtube.com/watch?v=", ::GetSegment(path, 0));
+  }
+
+  if (("youtube.com" == host) || ("music.youtube.com" == host)) {
+    auto const kind = ::GetSegment(path, 0);
+    if (("shorts" == kind) || ("embed" == kind) || ("live" == kind) || ("v" == kind)) {
+      return ::WithId("youtube.com/watch?v=", ::GetSegment(path, 1));
+    }
+    if ("watch" == kind) {
+      return ::WithId("youtube.com/watch?v=", ::FindParameter(parameters, "v"));
+    }
+  }
+
+  if ("clips.twitch.tv" == host) {
+    auto const slug = ("embed" == ::GetSegment(path, 0)) ? ::FindParameter(parameters, "clip") : ::GetSegment(path, 0);
+    return ::WithId("twitch.tv/clip/", slug);
+  }
+
+  if ("twitch.tv" == host) {
+    if ("clip" == ::GetSegment(path, 0)) {
+      return ::WithId("twitch.tv/clip/", ::GetSegment(path, 1));
+    }
+    if ("clip" == ::GetSegment(path, 1)) {
+      return ::WithId("twitch.tv/clip/", ::GetSegment(path, 2));
+    }
+    return std::string(host).append(path);
+  }
+
+  std::string canonical_url(host);
+  canonical_url.append(path);
+  if (kSignedHosts.cend() != std::ranges::find(kSignedHosts, host)) {
+    return canonical_url;
+  }
+
+  std::vector<Parameter> kept_parameters;
+  std::ranges::copy_if(parameters, std::back_inserter(kept_parameters), [](auto const& parameter) { return !::IsTracking(parameter.first); });
+  std::ranges::sort(kept_parameters);
+  for (std::size_t parameter_index = 0; parameter_index < kept_parameters.size(); ++parameter_index) {
+    canonical_url.append((0 == parameter_index) ? "?" : "&").append(kept_parameters[parameter_index].first);
+    if (!kept_parameters[parameter_index].second.empty()) {
+      canonical_url.append("=").append(kept_parameters[parameter_index].second);
+    }
+  }
+
+  return canonical_url;
+}
\ No newline at end of file
@@ -0,0 +1,13 @@
+#pragma once
+
+#include <string>
+#include <string_view>
+
+// Reduces the many forms a clip URL is posted in to a single key: scheme, "www."/"m." prefixes,
+// fragments and tracking parameters are dropped, youtu.be, Shorts, embed and live links become
+// YouTube watch links, and every Twitch clip link becomes twitch.tv/clip/<slug>. The result is only
+// used to detect reposts; nominations still show the URL as it was posted. YouTube and Twitch clip
+// links without a video id or clip slug canonicalize to an empty string, since they name no clip.
+struct ClipUrl {
+  static std::string Canonicalize(std::string_view url);
+};
\ No newline at end of file
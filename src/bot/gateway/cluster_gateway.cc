@@ -0,0 +1,66 @@
+#include "cluster_gateway.h"
+
+ClusterGateway::ClusterGateway(std::shared_ptr<dpp::cluster> bot) noexcept :
+  bot_(std::move(bot)) {
+  // The timer lives in the cluster, so it holds neither the cluster nor this gateway.
+  timer_ = bot_->start_timer([bot = bot_.get(), shards = shards_](dpp::timer const) {
+    ClusterGateway::Tick(*bot, *shards);
+  }, 1);
+}
+
+ClusterGateway::~ClusterGateway() {
+  bot_->stop_timer(timer_);
+}
+
+std::vector<Gateway::ShardStatus> ClusterGateway::GetShards() {
+  std::scoped_lock<std::mutex> const mutex_lock(shards_->mutex);
+  return shards_->statuses;
+}
+
+void ClusterGateway::Resume(uint32_t const shard_id) {
+  std::scoped_lock<std::mutex> const mutex_lock(shards_->mutex);
+  shards_->pending_actions.emplace_back(shard_id, Action::kResume);
+}
+
+void ClusterGateway::Reconnect(uint32_t const shard_id) {
+  std::scoped_lock<std::mutex> const mutex_lock(shards_->mutex);
+  shards_->pending_actions.emplace_back(shard_id, Action::kReconnect);
+}
+
+void ClusterGateway::Tick(dpp::cluster& bot, Shards& shards) noexcept {
+  std::vector<std::pair<uint32_t, Action>> pending_actions;
+  {
+    std::scoped_lock<std::mutex> const mutex_lock(shards.mutex);
+    pending_actions.swap(shards.pending_actions);
+  }
+
+  for (auto const& [shard_id, action] : pending_actions) {
+    auto* const shard = bot.get_shard(shard_id);
+    if (nullptr == shard) {
+      continue;
+    }
+
+    // Closing the socket makes DPP reconnect the shard and resume its session where it left off.
+    // Without a session id DPP identifies again instead of resuming, which starts a fresh session.
+    if (Action::kReconnect == action) {
+      shard->sessionid.clear();
+    }
+    shard->close();
+  }
+
+  std::vector<ShardStatus> statuses;
+  for (auto const& [shard_id, shard] : bot.get_shards()) {
+    statuses.push_back(ShardStatus{
+      .shard_id = shard_id,
+      .connected = shard->is_connected(),
+      .heartbeat_interval = std::chrono::milliseconds(shard->heartbeat_interval),
+      .last_heartbeat = std::chrono::system_clock::from_time_t(shard->last_heartbeat),
+      .last_heartbeat_ack = std::chrono::system_clock::from_time_t(shard->last_heartbeat_ack),
+      .round_trip = std::chrono::duration_cast<std::chrono::microseconds>(std::chrono::duration<double>(shard->websocket_ping)),
+      .bytes_in = shard->get_bytes_in()
+    });
+  }
+
+  std::scoped_lock<std::mutex> const mutex_lock(shards.mutex);
+  shards.statuses = std::move(statuses);
+}
\ No newline at end of file
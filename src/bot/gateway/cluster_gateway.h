@@ -0,0 +1,45 @@
+#pragma once
+
+#include <cstdint>
+#include <memory>
+#include <mutex>
+#include <utility>
+#include <vector>
+
+#include <dpp/dpp.h>
+
+#include "gateway.h"
+
+// Gateway over the live cluster. DPP ticks timers on the thread that services the shards, so a
+// one second timer reads every shard and applies the resumes and reconnects the monitor asked for
+// there, and the monitor only ever sees the last snapshot.
+class ClusterGateway final : public Gateway {
+public:
+  ClusterGateway() = delete;
+  ~ClusterGateway() override;
+
+  ClusterGateway(std::shared_ptr<dpp::cluster> bot) noexcept;
+
+  std::vector<ShardStatus> GetShards() override;
+  void Resume(uint32_t shard_id) override;
+  void Reconnect(uint32_t shard_id) override;
+
+private:
+  enum class Action {
+    kResume,
+    kReconnect
+  };
+
+  struct Shards {
+    std::mutex mutex;
+    std::vector<ShardStatus> statuses;
+    std::vector<std::pair<uint32_t, Action>> pending_actions;
+  };
+
+  static void Tick(dpp::cluster& bot, Shards& shards) noexcept;
+
+private:
+  std::shared_ptr<dpp::cluster> const bot_;
+  std::shared_ptr<Shards> const shards_ = std::make_shared<Shards>();
+  dpp::timer timer_{};
+};
\ No newline at end of file
@@ -0,0 +1,27 @@
+#pragma once
+
+#include <chrono>
+#include <cstdint>
+#include <vector>
+
+// Gateway surface watched by the health monitor. Reports the heartbeat state of every shard and
+// lets the monitor force a shard to resume or to start a new session, either on the live cluster
+// (ClusterGateway) or on the stand-in used to rehearse stalls (GatewayStandIn).
+class Gateway {
+public:
+  struct ShardStatus {
+    uint32_t shard_id{};
+    bool connected{};
+    std::chrono::milliseconds heartbeat_interval{};
+    std::chrono::system_clock::time_point last_heartbeat;
+    std::chrono::system_clock::time_point last_heartbeat_ack;
+    std::chrono::microseconds round_trip{};
+    uint64_t bytes_in{};
+  };
+
+  virtual ~Gateway() = default;
+
+  virtual std::vector<ShardStatus> GetShards() = 0;
+  virtual void Resume(uint32_t shard_id) = 0;
+  virtual void Reconnect(uint32_t shard_id) = 0;
+};
\ No newline at end of file
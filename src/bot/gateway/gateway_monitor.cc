@@ -0,0 +1,147 @@
+#include "gateway_monitor.h"
+
+#include <utility>
+
+GatewayMonitor::GatewayMonitor(std::shared_ptr<Gateway> gateway, Settings::GatewayHealthSettings const& health_settings) :
+  gateway_(std::move(gateway)),
+  health_settings_(health_settings),
+  thread_(&GatewayMonitor::Run, this) {
+
+}
+
+GatewayMonitor::~GatewayMonitor() {
+  Stop();
+}
+
+void GatewayMonitor::Stop() noexcept {
+  {
+    std::scoped_lock<std::mutex> const mutex_lock(mutex_);
+    stopping_ = true;
+  }
+  condition_.notify_all();
+
+  if (thread_.joinable()) {
+    thread_.join();
+  }
+}
+
+std::vector<GatewayMonitor::ShardStats> GatewayMonitor::GetStats() const noexcept {
+  std::scoped_lock<std::mutex> const mutex_lock(mutex_);
+
+  std::vector<ShardStats> shards_stats;
+  for (auto const& [shard_id, health] : shards_) {
+    shards_stats.push_back(ShardStats{
+      .shard_id = shard_id,
+      .healthy = State::kHealthy == health.state,
+      .round_trip_p50 = health.round_trip.GetPercentile(0.50),
+      .round_trip_p99 = health.round_trip.GetPercentile(0.99),
+      .round_trip_max = health.round_trip.GetMax(),
+      .stalls = health.stalls,
+      .resumes = health.resumes,
+      .reconnects = health.reconnects,
+      .recoveries = health.recovery.GetCount(),
+      .recovery_p50 = health.recovery.GetPercentile(0.50),
+      .recovery_max = health.recovery.GetMax()
+    });
+  }
+
+  return shards_stats;
+}
+
+void GatewayMonitor::Report() const noexcept {
+  for (auto const& shard_stats : GetStats()) {
+    logger_.Info("Shard {} is {}. Heartbeat round trip p50 {} ms, p99 {} ms, max {} ms. {} stalls, {} resumes, {} reconnects, {} recoveries (p50 {} ms, max {} ms)",
+                 shard_stats.shard_id, shard_stats.healthy ? "healthy" : "recovering",
+                 shard_stats.round_trip_p50.count() / 1000, shard_stats.round_trip_p99.count() / 1000, shard_stats.round_trip_max.count() / 1000,
+                 shard_stats.stalls, shard_stats.resumes, shard_stats.reconnects, shard_stats.recoveries, shard_stats.recovery_p50.count() / 1000, shard_stats.recovery_max.count() / 1000);
+  }
+}
+
+void GatewayMonitor::Check(Gateway::ShardStatus const& shard, std::chrono::system_clock::time_point const now) noexcept {
+  auto& health = shards_[shard.shard_id];
+  if (shard.last_heartbeat_ack != health.last_heartbeat_ack) {
+    health.last_heartbeat_ack = shard.last_heartbeat_ack;
+    if (0 != shard.round_trip.count()) {
+      health.round_trip.Record(shard.round_trip);
+    }
+  }
+  if ((shard.bytes_in != health.bytes_in) || (State::kConnecting == health.state)) {
+    health.bytes_in = shard.bytes_in;
+    health.last_inbound = now;
+  }
+  if (shard.connected || (State::kConnecting == health.state)) {
+    health.disconnected_since = now;
+  }
+
+  if (State::kConnecting == health.state) {
+    if (shard.connected) {
+      logger_.Info("Shard {} connected", shard.shard_id);
+      health.state = State::kHealthy;
+    }
+    return;
+  }
+
+  auto const missed_heartbeat_ack = shard.connected && (shard.last_heartbeat > shard.last_heartbeat_ack) && (now - shard.last_heartbeat > health_settings_.ack_timeout);
+  auto const inbound_gap = now - health.last_inbound > health_settings_.event_gap;
+  auto const disconnected = now - health.disconnected_since > health_settings_.resume_timeout;
+
+  switch (health.state) {
+    case State::kHealthy: {
+      if (!missed_heartbeat_ack && !inbound_gap && !disconnected) {
+        break;
+      }
+
+      logger_.Warn("Shard {} stalled ({}), resuming", shard.shard_id, missed_heartbeat_ack ? "heartbeat not acknowledged" : (inbound_gap ? "nothing received" : "disconnected"));
+      ++health.stalls;
+      ++health.resumes;
+      health.stall_start = missed_heartbeat_ack ? shard.last_heartbeat : (inbound_gap ? health.last_inbound : health.disconnected_since);
+      health.action_time = now;
+      health.state = State::kResuming;
+      gateway_->Resume(shard.shard_id);
+      break;
+    }
+    case State::kResuming: {
+      [[fallthrough]];
+    }
+    case State::kReconnecting: {
+      if (shard.connected && !missed_heartbeat_ack && (health.last_inbound > health.action_time)) {
+        health.recovery.Record(now - health.stall_start);
+        health.state = State::kHealthy;
+        logger_.Info("Shard {} recovered in {} ms", shard.shard_id, std::chrono::duration_cast<std::chrono::milliseconds>(now - health.stall_start).count());
+        break;
+      }
+
+      auto const timeout = (State::kResuming == health.state) ? health_settings_.resume_timeout : health_settings_.reconnect_timeout;
+      if (now - health.action_time > timeout) {
+        logger_.Warn("Shard {} did not recover after {} ms, reconnecting with a new session", shard.shard_id, std::chrono::duration_cast<std::chrono::milliseconds>(now - health.stall_start).count());
+        ++health.reconnects;
+        health.action_time = now;
+        health.state = State::kReconnecting;
+        gateway_->Reconnect(shard.shard_id);
+      }
+      break;
+    }
+    default: {
+      break;
+    }
+  }
+}
+
+void GatewayMonitor::Run() {
+  std::unique_lock<std::mutex> mutex_lock(mutex_);
+  while (!stopping_) {
+    condition_.wait_for(mutex_lock, health_settings_.check_interval, [this]() { return stopping_; });
+    if (stopping_) {
+      return;
+    }
+
+    mutex_lock.unlock();
+    auto const shards = gateway_->GetShards();
+    mutex_lock.lock();
+
+    auto const now = std::chrono::system_clock::now();
+    for (auto const& shard : shards) {
+      Check(shard, now);
+    }
+  }
+}
\ No newline at end of file
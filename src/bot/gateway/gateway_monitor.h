@@ -0,0 +1,86 @@
+#pragma once
+
+#include <chrono>
+#include <condition_variable>
+#include <cstdint>
+#include <map>
+#include <memory>
+#include <mutex>
+#include <thread>
+#include <vector>
+
+#include "gateway.h"
+#include "logger/logger_factory.h"
+#include "metrics/latency_histogram.h"
+#include "settings/settings.h"
+
+// Watches every shard for stalls that the websocket itself does not notice: a heartbeat that is
+// not acknowledged in time, a connection that receives nothing for too long, or a shard that stays
+// disconnected. A stalled shard is told to resume; if it has not received anything by the resume
+// timeout it is reconnected with a new session, again after every reconnect timeout until it
+// recovers. Heartbeat round trips are kept per shard, and so is time to recovery, measured from the
+// moment the shard went quiet rather than from when the stall was noticed.
+class GatewayMonitor final {
+public:
+  struct ShardStats {
+    uint32_t shard_id{};
+    bool healthy{};
+    std::chrono::microseconds round_trip_p50{};
+    std::chrono::microseconds round_trip_p99{};
+    std::chrono::microseconds round_trip_max{};
+    uint64_t stalls{};
+    uint64_t resumes{};
+    uint64_t reconnects{};
+    uint64_t recoveries{};
+    std::chrono::microseconds recovery_p50{};
+    std::chrono::microseconds recovery_max{};
+  };
+
+  GatewayMonitor() = delete;
+  ~GatewayMonitor();
+
+  GatewayMonitor(std::shared_ptr<Gateway> gateway, Settings::GatewayHealthSettings const& health_settings);
+
+  void Stop() noexcept;
+
+  std::vector<ShardStats> GetStats() const noexcept;
+  void Report() const noexcept;
+
+private:
+  enum class State {
+    kConnecting,
+    kHealthy,
+    kResuming,
+    kReconnecting
+  };
+
+  struct ShardHealth {
+    State state = State::kConnecting;
+    std::chrono::system_clock::time_point last_heartbeat_ack;
+    uint64_t bytes_in{};
+    std::chrono::system_clock::time_point last_inbound;
+    std::chrono::system_clock::time_point disconnected_since;
+    std::chrono::system_clock::time_point stall_start;
+    std::chrono::system_clock::time_point action_time;
+    uint64_t stalls{};
+    uint64_t resumes{};
+    uint64_t reconnects{};
+    LatencyHistogram round_trip;
+    LatencyHistogram recovery;
+  };
+
+  void Check(Gateway::ShardStatus const& shard, std::chrono::system_clock::time_point now) noexcept;
+  void Run();
+
+private:
+  Logger const logger_ = LoggerFactory::Get().Create("Gateway Monitor");
+
+  std::shared_ptr<Gateway> const gateway_;
+  Settings::GatewayHealthSettings const health_settings_;
+
+  std::map<uint32_t, ShardHealth> shards_;
+  bool stopping_{};
+  mutable std::mutex mutex_;
+  std::condition_variable condition_;
+  std::thread thread_;
+};
\ No newline at end of file
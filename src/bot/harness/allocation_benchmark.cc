@@ -0,0 +1,91 @@
+#include "allocation_benchmark.h"
+
+#include <array>
+#include <cstddef>
+#include <format>
+#include <iterator>
+#include <memory_resource>
+#include <string>
+
+#include <dpp/dpp.h>
+
+#include "metrics/allocation_counter.h"
+#include "presence/stream_matcher.h"
+#include "settings/settings.h"
+
+namespace {
+  auto constexpr kIterations = 10000ULL;
+  auto constexpr kArenaBytes = std::size_t{16 * 1024};
+
+  auto constexpr kChannelId = 1018992321632686170ULL;
+  auto constexpr kUserId = 146391850012377088ULL;
+  auto constexpr kAnnouncement = "A final do torneio de 70 estrelas começa hoje às 20h, com transmissão no canal oficial!";
+  auto constexpr kDetails = "120 Star PB attempts";
+  auto constexpr kUrl = "https://www.twitch.tv/runner";
+}
+
+bool AllocationBenchmark::Run() const {
+  if (!AllocationCounter::IsEnabled()) {
+    logger_.Error("Allocations are only counted in builds configured with -DSM64BR_COUNT_ALLOCATIONS=ON");
+    return false;
+  }
+
+  std::array<std::byte, ::kArenaBytes> arena_buffer;
+  std::pmr::monotonic_buffer_resource arena(arena_buffer.data(), arena_buffer.size(), std::pmr::null_memory_resource());
+
+  // Announcements, the message every handler that posts to a channel resembles.
+  auto const announcement_copy = Measure([]() {
+    auto const announcement = std::format("@everyone {}", ::kAnnouncement);
+    auto const message = dpp::message(::kChannelId, announcement);
+  });
+  auto const announcement_arena = Measure([&arena]() {
+    arena.release();
+    std::pmr::string announcement(&arena);
+    std::format_to(std::back_inserter(announcement), "@everyone {}", ::kAnnouncement);
+    auto const message = dpp::message(::kChannelId, std::string(announcement));
+  });
+  auto const announcement_moved = Measure([]() {
+    dpp::message message(::kChannelId, std::string());
+    message.content = std::format("@everyone {}", ::kAnnouncement);
+  });
+
+  // Stream posts, which format three fields.
+  auto const stream_copy = Measure([]() {
+    auto const content = std::format("{} **{}**\n{}", dpp::user::get_mention(::kUserId), ::kDetails, ::kUrl);
+    auto const message = dpp::message(::kChannelId, content);
+  });
+  auto const stream_arena = Measure([&arena]() {
+    arena.release();
+    std::pmr::string content(&arena);
+    std::format_to(std::back_inserter(content), "{} **{}**\n{}", dpp::user::get_mention(::kUserId), ::kDetails, ::kUrl);
+    auto const message = dpp::message(::kChannelId, std::string(content));
+  });
+  auto const stream_moved = Measure([]() {
+    dpp::message message(::kChannelId, std::string());
+    message.content = std::format("{} **{}**\n{}", dpp::user::get_mention(::kUserId), ::kDetails, ::kUrl);
+  });
+
+  auto const stream_matcher = StreamMatcher({Settings::StreamRule{.platform = "Twitch", .games = {"Super Mario 64"}, .keywords = {"PB", "WR"}}});
+  dpp::activity activity;
+  activity.type = dpp::activity_type::at_streaming;
+  activity.name = "Twitch";
+  activity.state = "Super Mario 64";
+  activity.details = ::kDetails;
+  auto const stream_match = Measure([&stream_matcher, &activity]() { static_cast<void>(stream_matcher.Matches(activity)); });
+
+  logger_.Info("Announcement: {:.1f} allocations copying a heap string, {:.1f} copying an arena string, {:.1f} formatting into the message",
+               announcement_copy, announcement_arena, announcement_moved);
+  logger_.Info("Stream post: {:.1f} allocations copying a heap string, {:.1f} copying an arena string, {:.1f} formatting into the message",
+               stream_copy, stream_arena, stream_moved);
+  logger_.Info("Stream match: {:.1f} allocations", stream_match);
+  return (announcement_moved < announcement_copy) && (announcement_moved <= announcement_arena) && (stream_moved < stream_copy) && (stream_moved <= stream_arena) &&
+         (0.0 == stream_match);
+}
+
+double AllocationBenchmark::Measure(std::function<void()> const& work) {
+  auto const allocations_start = AllocationCounter::GetThread();
+  for (auto i = 0ULL; i < kIterations; ++i) {
+    work();
+  }
+  return static_cast<double>(AllocationCounter::GetThread() - allocations_start) / static_cast<double>(kIterations);
+}
\ No newline at end of file
@@ -0,0 +1,26 @@
+#pragma once
+
+#include <functional>
+
+#include "logger/logger_factory.h"
+
+// Counts the heap allocations it takes to build the messages the handlers post, three ways: a
+// formatted string copied into dpp::message, as the handlers first did; a string formatted in a
+// per-event arena and copied into dpp::message, as they did with the event arena; and a string
+// formatted straight into the message's content, as they do now. It also counts the allocations
+// of a stream match.
+class AllocationBenchmark final {
+public:
+  AllocationBenchmark() = default;
+  ~AllocationBenchmark() = default;
+
+  // Returns true when building into the message allocates less than the heap copy and no more
+  // than the arena copy, and a stream match allocates nothing.
+  bool Run() const;
+
+private:
+  static double Measure(std::function<void()> const& work);
+
+private:
+  Logger const logger_ = LoggerFactory::Get().Create("Allocation Benchmark");
+};
\ No newline at end of file
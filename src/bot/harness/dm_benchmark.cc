@@ -0,0 +1,45 @@
+#include "dm_benchmark.h"
+
+#include <filesystem>
+#include <latch>
+#include <memory>
+
+#include <dpp/dpp.h>
+
+#include "cache/dm_channel_cache.h"
+#include "message/direct_messenger.h"
+#include "rest_stand_in.h"
+
+namespace {
+  auto constexpr kUsers = 8ULL;
+  auto constexpr kDirectMessagesPerUser = 5ULL;
+  auto constexpr kDirectMessages = kUsers * kDirectMessagesPerUser;
+}
+
+bool DmBenchmark::Run() const {
+  auto const log_path = (std::filesystem::temp_directory_path() / "sm64br_dm_benchmark.jsonl").string();
+  std::filesystem::remove(log_path);
+
+  auto const cold_requests = SendBurst(log_path);
+  auto const warm_requests = SendBurst(log_path);
+  std::filesystem::remove(log_path);
+
+  logger_.Info("{} DMs to {} users took {} REST calls with an empty DM channel cache ({:.2f} per DM) and {} with a persisted one ({:.2f} per DM), {} saved",
+               kDirectMessages, kUsers, cold_requests, static_cast<double>(cold_requests) / kDirectMessages, warm_requests, static_cast<double>(warm_requests) / kDirectMessages,
+               cold_requests - warm_requests);
+  return warm_requests < cold_requests;
+}
+
+std::size_t DmBenchmark::SendBurst(std::string const& log_path) {
+  auto const rest = std::make_shared<RestStandIn>();
+  DirectMessenger direct_messenger(rest, std::make_shared<DmChannelCache>(log_path));
+
+  std::latch sent(kDirectMessages);
+  for (auto i = 0ULL; i < kDirectMessagesPerUser; ++i) {
+    for (auto user_id = 1ULL; user_id <= kUsers; ++user_id) {
+      direct_messenger.Send(dpp::snowflake(user_id), dpp::message("Benchmark nomination"), [&sent](dpp::confirmation_callback_t const&) { sent.count_down(); });
+    }
+  }
+  sent.wait();
+  return rest->GetRequestCount();
+}
\ No newline at end of file
@@ -0,0 +1,24 @@
+#pragma once
+
+#include <cstddef>
+#include <string>
+
+#include "logger/logger_factory.h"
+
+// Sends the same burst of nomination DMs twice against the REST stand-in, first with an empty DM
+// channel cache and then with the one the first burst persisted, as the first burst after a
+// restart would go without and with the cache.
+class DmBenchmark final {
+public:
+  DmBenchmark() = default;
+  ~DmBenchmark() = default;
+
+  // Returns true when the persisted cache saved REST calls.
+  bool Run() const;
+
+private:
+  static std::size_t SendBurst(std::string const& log_path);
+
+private:
+  Logger const logger_ = LoggerFactory::Get().Create("DM Benchmark");
+};
\ No newline at end of file
@@ -0,0 +1,74 @@
+#include "event_benchmark.h"
+
+#include <vector>
+
+#include <malloc.h>
+
+#include <dpp/dpp.h>
+#include <nlohmann/json.hpp>
+
+#include "message/message_event.h"
+#include "presence/presence_event.h"
+#include "presence/stream_matcher.h"
+#include "settings/settings.h"
+
+namespace {
+  auto constexpr kEvents = 1000ULL;
+}
+
+bool EventBenchmark::Run() const {
+  auto message_json = nlohmann::json::parse(R"({
+    "id": "1320204114902126700", "channel_id": "1320204114902126632", "guild_id": "1018992321632686100",
+    "author": {"id": "146391850012377088", "username": "runner", "global_name": "Runner", "avatar": "a_0123456789abcdef0123456789abcdef"},
+    "member": {"nick": "Runner", "roles": ["1018992321632686170", "1196549524907364483"], "joined_at": "2023-01-01T00:00:00.000000+00:00"},
+    "content": "Novo recorde de 120 estrelas! https://www.youtube.com/watch?v=0123456789a",
+    "timestamp": "2024-12-21T18:00:00.000000+00:00",
+    "embeds": [{"type": "video", "title": "SM64 120 Star Speedrun", "description": "Personal best, full run with commentary and splits in the description.",
+                "url": "https://www.youtube.com/watch?v=0123456789a", "thumbnail": {"url": "https://i.ytimg.com/vi/0123456789a/maxresdefault.jpg", "width": 1280, "height": 720}}],
+    "attachments": [{"id": "1320204114902126701", "filename": "pb.mp4", "size": 52428800, "content_type": "video/mp4",
+                     "url": "https://cdn.discordapp.com/attachments/1320204114902126632/1320204114902126701/pb.mp4", "proxy_url": "https://media.discordapp.net/attachments/1320204114902126632/1320204114902126701/pb.mp4"},
+                    {"id": "1320204114902126702", "filename": "splits.png", "size": 204800, "content_type": "image/png",
+                     "url": "https://cdn.discordapp.com/attachments/1320204114902126632/1320204114902126702/splits.png", "proxy_url": "https://media.discordapp.net/attachments/1320204114902126632/1320204114902126702/splits.png"}]
+  })");
+  dpp::message message;
+  message.fill_from_json(&message_json);
+
+  auto presence_json = nlohmann::json::parse(R"({
+    "guild_id": "1018992321632686100", "user": {"id": "146391850012377088"}, "status": "online", "client_status": {"desktop": "online"},
+    "activities": [
+      {"name": "Twitch", "type": 1, "url": "https://www.twitch.tv/runner", "details": "120 Star PB attempts", "state": "Super Mario 64", "created_at": 1734800000000,
+       "assets": {"large_image": "twitch:runner", "large_text": "Super Mario 64"}},
+      {"name": "Super Mario 64", "type": 0, "details": "Bob-omb Battlefield", "state": "Star 1", "created_at": 1734800000000, "application_id": "1018992321632686199"},
+      {"name": "Custom Status", "type": 4, "state": "Grinding the 120 star category", "created_at": 1734800000000}
+    ]
+  })");
+  dpp::presence presence;
+  presence.fill_from_json(&presence_json);
+
+  auto const stream_matcher = StreamMatcher({Settings::StreamRule{.platform = "Twitch", .games = {"Super Mario 64"}}});
+
+  auto const message_copy_bytes = Measure([&message]() -> AdmissionController::Work { return [message]() -> dpp::task<void> { co_return; }; });
+  auto const message_event_bytes = Measure([&message]() -> AdmissionController::Work {
+    return [message_event = MessageEvent::FromMessage(message)]() -> dpp::task<void> { co_return; };
+  });
+  auto const presence_copy_bytes = Measure([&presence]() -> AdmissionController::Work { return [presence]() -> dpp::task<void> { co_return; }; });
+  auto const presence_event_bytes = Measure([&presence, &stream_matcher]() -> AdmissionController::Work {
+    return [presence_event = PresenceEvent::FromPresence(presence, stream_matcher)]() -> dpp::task<void> { co_return; };
+  });
+
+  logger_.Info("Message: {} bytes per event copying dpp::message, {} with MessageEvent ({} bytes of it the event itself)",
+               message_copy_bytes, message_event_bytes, MessageEvent::FromMessage(message).GetBytes());
+  logger_.Info("Presence: {} bytes per event copying dpp::presence, {} with PresenceEvent ({} bytes of it the event itself)",
+               presence_copy_bytes, presence_event_bytes, PresenceEvent::FromPresence(presence, stream_matcher).GetBytes());
+  return (message_event_bytes < message_copy_bytes) && (presence_event_bytes < presence_copy_bytes);
+}
+
+std::size_t EventBenchmark::Measure(std::function<AdmissionController::Work()> const& make_work) {
+  std::vector<AdmissionController::Work> queued_work;
+  queued_work.reserve(kEvents);
+  auto const heap_start = mallinfo2().uordblks;
+  for (auto i = 0ULL; i < kEvents; ++i) {
+    queued_work.push_back(make_work());
+  }
+  return sizeof(AdmissionController::Work) + (mallinfo2().uordblks - heap_start) / kEvents;
+}
\ No newline at end of file
@@ -0,0 +1,25 @@
+#pragma once
+
+#include <cstddef>
+#include <functional>
+
+#include "admission/admission_controller.h"
+#include "logger/logger_factory.h"
+
+// Hands the same clip message and streaming presence to queued work the way the handlers used to,
+// copying the whole DPP object into the work, and the way they do now, extracting a compact event
+// and moving it in. Bytes are what the heap grew by while the work was held, plus the work itself.
+class EventBenchmark final {
+public:
+  EventBenchmark() = default;
+  ~EventBenchmark() = default;
+
+  // Returns true when the compact events cost fewer bytes than the copies for both event types.
+  bool Run() const;
+
+private:
+  static std::size_t Measure(std::function<AdmissionController::Work()> const& make_work);
+
+private:
+  Logger const logger_ = LoggerFactory::Get().Create("Event Benchmark");
+};
\ No newline at end of file
@@ -0,0 +1,41 @@
+#include "gateway_drill.h"
+
+#include <algorithm>
+#include <chrono>
+#include <memory>
+#include <thread>
+
+#include "gateway_stand_in.h"
+#include "settings/settings.h"
+
+bool GatewayDrill::Run() const {
+  using namespace std::chrono_literals;
+
+  auto const gateway = std::make_shared<GatewayStandIn>(2, 1s, 40ms);
+  GatewayMonitor monitor(gateway, Settings::GatewayHealthSettings{.check_interval = 100ms, .ack_timeout = 500ms, .event_gap = 3s, .resume_timeout = 2s, .reconnect_timeout = 5s});
+
+  std::this_thread::sleep_for(3s);
+  gateway->DropHeartbeats(0, false);
+  auto const resumed = WaitRecovered(monitor, 0);
+  gateway->DropHeartbeats(1, true);
+  auto const reconnected = WaitRecovered(monitor, 1);
+
+  monitor.Report();
+  logger_.Info("Shard 0 {} resumed, shard 1 {} reconnected", resumed ? "was" : "was not", reconnected ? "was" : "was not");
+  return resumed && reconnected;
+}
+
+bool GatewayDrill::WaitRecovered(GatewayMonitor const& monitor, uint32_t const shard_id) {
+  using namespace std::chrono_literals;
+
+  auto const deadline = std::chrono::steady_clock::now() + 20s;
+  while (std::chrono::steady_clock::now() < deadline) {
+    std::this_thread::sleep_for(100ms);
+    auto const shards_stats = monitor.GetStats();
+    auto const it_shard_stats = std::ranges::find(shards_stats, shard_id, &GatewayMonitor::ShardStats::shard_id);
+    if ((shards_stats.cend() != it_shard_stats) && it_shard_stats->healthy && (0 != it_shard_stats->recoveries)) {
+      return true;
+    }
+  }
+  return false;
+}
\ No newline at end of file
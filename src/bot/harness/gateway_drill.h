@@ -0,0 +1,23 @@
+#pragma once
+
+#include <cstdint>
+
+#include "gateway/gateway_monitor.h"
+#include "logger/logger_factory.h"
+
+// Runs the gateway monitor against simulated shards: one loses its heartbeats and has to be
+// resumed, the other also has its resume rejected and has to be reconnected.
+class GatewayDrill final {
+public:
+  GatewayDrill() = default;
+  ~GatewayDrill() = default;
+
+  // Returns true when both shards were recovered.
+  bool Run() const;
+
+private:
+  static bool WaitRecovered(GatewayMonitor const& monitor, uint32_t shard_id);
+
+private:
+  Logger const logger_ = LoggerFactory::Get().Create("Gateway Drill");
+};
\ No newline at end of file
@@ -0,0 +1,116 @@
+#include "gateway_stand_in.h"
+
+namespace {
+  auto constexpr kTick = std::chrono::milliseconds(10);
+  auto constexpr kResumeDelay = std::chrono::milliseconds(250);
+  auto constexpr kIdentifyDelay = std::chrono::seconds(1);
+  auto constexpr kEventBytesPerTick = 128ULL;
+  auto constexpr kSessionStartBytes = 4096ULL;
+  auto constexpr kHeartbeatAckBytes = 32ULL;
+}
+
+GatewayStandIn::GatewayStandIn(std::size_t const shards, std::chrono::milliseconds const heartbeat_interval, std::chrono::milliseconds const round_trip) :
+  round_trip_(round_trip),
+  shards_(shards) {
+  auto const now = std::chrono::system_clock::now();
+  for (std::size_t shard_index = 0; shard_index < shards_.size(); ++shard_index) {
+    shards_[shard_index].status.shard_id = static_cast<uint32_t>(shard_index);
+    shards_[shard_index].status.heartbeat_interval = heartbeat_interval;
+    shards_[shard_index].connect_due = now;
+  }
+
+  thread_ = std::thread(&GatewayStandIn::Run, this);
+  logger_.Info("Simulating {} shards with {} ms heartbeats and {} ms round trip", shards, heartbeat_interval.count(), round_trip.count());
+}
+
+GatewayStandIn::~GatewayStandIn() {
+  {
+    std::scoped_lock<std::mutex> const mutex_lock(mutex_);
+    stopping_ = true;
+  }
+  condition_.notify_all();
+  thread_.join();
+}
+
+std::vector<Gateway::ShardStatus> GatewayStandIn::GetShards() {
+  std::scoped_lock<std::mutex> const mutex_lock(mutex_);
+
+  std::vector<ShardStatus> shards;
+  for (auto const& shard : shards_) {
+    shards.push_back(shard.status);
+  }
+  return shards;
+}
+
+void GatewayStandIn::Resume(uint32_t const shard_id) {
+  std::scoped_lock<std::mutex> const mutex_lock(mutex_);
+
+  auto& shard = shards_.at(shard_id);
+  shard.status.connected = false;
+  shard.ack_pending = false;
+  if (shard.resume_fails) {
+    logger_.Info("Rejecting resume of shard {}", shard_id);
+    shard.connect_due = std::chrono::system_clock::time_point::max();
+    return;
+  }
+
+  shard.dropping = false;
+  shard.connect_due = std::chrono::system_clock::now() + kResumeDelay;
+}
+
+void GatewayStandIn::Reconnect(uint32_t const shard_id) {
+  std::scoped_lock<std::mutex> const mutex_lock(mutex_);
+
+  auto& shard = shards_.at(shard_id);
+  shard.status.connected = false;
+  shard.ack_pending = false;
+  shard.dropping = false;
+  shard.resume_fails = false;
+  shard.connect_due = std::chrono::system_clock::now() + kIdentifyDelay;
+}
+
+void GatewayStandIn::DropHeartbeats(uint32_t const shard_id, bool const resume_fails) noexcept {
+  std::scoped_lock<std::mutex> const mutex_lock(mutex_);
+
+  logger_.Info("Dropping everything sent to shard {}{}", shard_id, resume_fails ? " and rejecting its resume" : "");
+  shards_.at(shard_id).dropping = true;
+  shards_.at(shard_id).resume_fails = resume_fails;
+}
+
+void GatewayStandIn::Run() {
+  std::unique_lock<std::mutex> mutex_lock(mutex_);
+  while (!stopping_) {
+    condition_.wait_for(mutex_lock, kTick, [this]() { return stopping_; });
+
+    auto const now = std::chrono::system_clock::now();
+    for (auto& shard : shards_) {
+      auto& status = shard.status;
+      if (!status.connected) {
+        if (now >= shard.connect_due) {
+          status.connected = true;
+          status.bytes_in += kSessionStartBytes;
+          status.last_heartbeat = now;
+          status.last_heartbeat_ack = now;
+        }
+        continue;
+      }
+
+      if (now - status.last_heartbeat >= status.heartbeat_interval) {
+        status.last_heartbeat = now;
+        shard.ack_pending = !shard.dropping;
+        shard.ack_due = now + round_trip_;
+      }
+
+      if (shard.ack_pending && (now >= shard.ack_due)) {
+        shard.ack_pending = false;
+        status.last_heartbeat_ack = now;
+        status.round_trip = std::chrono::duration_cast<std::chrono::microseconds>(now - status.last_heartbeat);
+        status.bytes_in += kHeartbeatAckBytes;
+      }
+
+      if (!shard.dropping) {
+        status.bytes_in += kEventBytesPerTick;
+      }
+    }
+  }
+}
\ No newline at end of file
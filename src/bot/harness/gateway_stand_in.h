@@ -0,0 +1,52 @@
+#pragma once
+
+#include <chrono>
+#include <condition_variable>
+#include <cstddef>
+#include <cstdint>
+#include <mutex>
+#include <thread>
+#include <vector>
+
+#include "gateway/gateway.h"
+#include "logger/logger_factory.h"
+
+// Simulated gateway shards that heartbeat, receive acknowledgements after a fixed round trip and
+// a steady trickle of events. A shard can be made to drop everything it should receive, as a
+// zombied connection does after a network blip, until it is resumed, or until it is reconnected
+// when the blip also makes its session unresumable.
+class GatewayStandIn final : public Gateway {
+public:
+  GatewayStandIn() = delete;
+  ~GatewayStandIn() override;
+
+  GatewayStandIn(std::size_t shards, std::chrono::milliseconds heartbeat_interval, std::chrono::milliseconds round_trip);
+
+  std::vector<ShardStatus> GetShards() override;
+  void Resume(uint32_t shard_id) override;
+  void Reconnect(uint32_t shard_id) override;
+
+  void DropHeartbeats(uint32_t shard_id, bool resume_fails) noexcept;
+
+private:
+  struct Shard {
+    ShardStatus status;
+    bool dropping{};
+    bool resume_fails{};
+    bool ack_pending{};
+    std::chrono::system_clock::time_point ack_due;
+    std::chrono::system_clock::time_point connect_due;
+  };
+
+  void Run();
+
+private:
+  Logger const logger_ = LoggerFactory::Get().Create("Gateway Stand-In");
+
+  std::chrono::milliseconds const round_trip_;
+  std::vector<Shard> shards_;
+  bool stopping_{};
+  std::mutex mutex_;
+  std::condition_variable condition_;
+  std::thread thread_;
+};
\ No newline at end of file
@@ -0,0 +1,260 @@
+#include "rest_stand_in.h"
+
+#include <algorithm>
+#include <format>
+#include <utility>
+
+#include "settings/settings.h"
+
+namespace {
+  auto constexpr kMaxStoredMessages = 10000ULL;
+
+  dpp::message MakeNominationMessage(dpp::snowflake const message_id, dpp::snowflake const channel_id) {
+    dpp::message message(channel_id, "Replayed nomination\nhttps://clips.twitch.tv/ReplayedClip");
+    message.id = message_id;
+
+    auto const& guilds = Settings::Get().GetGuilds();
+    if (guilds.empty()) {
+      return message;
+    }
+
+    auto const& awards_reactions_and_categories = guilds.begin()->second.GetAwardsReactionsAndCategories();
+    if (!awards_reactions_and_categories.empty()) {
+      dpp::reaction reaction;
+      reaction.count = 2;
+      reaction.me = true;
+      reaction.emoji_name = awards_reactions_and_categories.begin()->first;
+      message.reactions.push_back(std::move(reaction));
+    }
+
+    return message;
+  }
+}
+
+RestStandIn::RestStandIn() :
+  latency_(Settings::Get().GetHarnessSettings().rest_latency),
+  rate_limit_requests_(Settings::Get().GetHarnessSettings().rate_limit_requests),
+  rate_limit_window_(Settings::Get().GetHarnessSettings().rate_limit_window),
+  thread_(&RestStandIn::Run, this) {
+  logger_.Info("Serving REST calls locally with {} ms latency and {} requests per {} ms route budget", latency_.count(), rate_limit_requests_, rate_limit_window_.count());
+}
+
+RestStandIn::~RestStandIn() {
+  {
+    std::scoped_lock<std::mutex> const mutex_lock(pending_responses_mutex_);
+    stopping_ = true;
+  }
+  pending_responses_condition_.notify_all();
+  if (thread_.joinable()) {
+    thread_.join();
+  }
+
+  logger_.Info("Served {} REST calls, {} retries after a 429", GetRequestCount(), GetRetryCount());
+}
+
+void RestStandIn::GuildGetMembers(dpp::snowflake const guild_id, uint16_t const limit, dpp::snowflake const after, dpp::command_completion_event_t callback) {
+  Respond(std::format("guild_get_members:{}", guild_id.str()), std::move(callback), dpp::guild_member_map{});
+}
+
+void RestStandIn::GuildMemberAddRole(dpp::snowflake const guild_id, dpp::snowflake const user_id, dpp::snowflake const role_id, dpp::command_completion_event_t callback) {
+  Respond(std::format("guild_member_role:{}", guild_id.str()), std::move(callback), dpp::confirmation{true}, 204);
+}
+
+void RestStandIn::GuildMemberRemoveRole(dpp::snowflake const guild_id, dpp::snowflake const user_id, dpp::snowflake const role_id, dpp::command_completion_event_t callback) {
+  Respond(std::format("guild_member_role:{}", guild_id.str()), std::move(callback), dpp::confirmation{true}, 204);
+}
+
+void RestStandIn::MessageCreate(dpp::message const& message, dpp::command_completion_event_t callback) {
+  if (message_create_observer_) {
+    message_create_observer_(message);
+  }
+  Respond(std::format("message_create:{}", message.channel_id.str()), std::move(callback), StoreMessage(message));
+}
+
+void RestStandIn::MessageEdit(dpp::message const& message, dpp::command_completion_event_t callback) {
+  {
+    std::scoped_lock<std::mutex> const mutex_lock(messages_mutex_);
+    auto const it_message = messages_.find(message.id);
+    if (messages_.cend() != it_message) {
+      it_message->second = message;
+    }
+  }
+
+  Respond(std::format("message_edit:{}", message.channel_id.str()), std::move(callback), dpp::message(message));
+}
+
+void RestStandIn::MessageDelete(dpp::snowflake const message_id, dpp::snowflake const channel_id, dpp::command_completion_event_t callback) {
+  {
+    std::scoped_lock<std::mutex> const mutex_lock(messages_mutex_);
+    messages_.erase(message_id);
+  }
+
+  Respond(std::format("message_delete:{}", channel_id.str()), std::move(callback), dpp::confirmation{true}, 204);
+}
+
+void RestStandIn::MessageGet(dpp::snowflake const message_id, dpp::snowflake const channel_id, dpp::command_completion_event_t callback) {
+  dpp::message message;
+  {
+    std::scoped_lock<std::mutex> const mutex_lock(messages_mutex_);
+    auto const it_message = messages_.find(message_id);
+    message = (messages_.cend() != it_message) ? it_message->second : ::MakeNominationMessage(message_id, channel_id);
+  }
+
+  Respond(std::format("message_get:{}", channel_id.str()), std::move(callback), std::move(message));
+}
+
+void RestStandIn::MessagesGet(dpp::snowflake const channel_id, dpp::snowflake const around, dpp::snowflake const before, dpp::snowflake const after, uint64_t const limit, dpp::command_completion_event_t callback) {
+  Respond(std::format("messages_get:{}", channel_id.str()), std::move(callback), dpp::message_map{});
+}
+
+void RestStandIn::MessageAddReaction(dpp::snowflake const message_id, dpp::snowflake const channel_id, std::string const& reaction, dpp::command_completion_event_t callback) {
+  {
+    std::scoped_lock<std::mutex> const mutex_lock(messages_mutex_);
+    auto const it_message = messages_.find(message_id);
+    if (messages_.cend() != it_message) {
+      auto& reactions = it_message->second.reactions;
+      auto const it_reaction = std::ranges::find_if(reactions, [&reaction](auto const& existing_reaction) { return existing_reaction.emoji_name == reaction; });
+      if (reactions.end() != it_reaction) {
+        ++it_reaction->count;
+      } else {
+        dpp::reaction new_reaction;
+        new_reaction.count = 1;
+        new_reaction.me = true;
+        new_reaction.emoji_name = reaction;
+        reactions.push_back(std::move(new_reaction));
+      }
+    }
+  }
+
+  Respond(std::format("message_add_reaction:{}", channel_id.str()), std::move(callback), dpp::confirmation{true}, 204);
+}
+
+void RestStandIn::CreateDmChannel(dpp::snowflake const user_id, dpp::command_completion_event_t callback) {
+  dpp::channel dm_channel;
+  dm_channel.recipients.push_back(user_id);
+  {
+    std::scoped_lock<std::mutex> const mutex_lock(messages_mutex_);
+    dm_channel.id = next_snowflake_++;
+  }
+
+  Respond("create_dm_channel", std::move(callback), std::move(dm_channel));
+}
+
+void RestStandIn::Close() noexcept {
+  {
+    std::scoped_lock<std::mutex> const mutex_lock(pending_responses_mutex_);
+    stopping_ = true;
+    pending_responses_ = {};
+  }
+  pending_responses_condition_.notify_all();
+  if (thread_.joinable()) {
+    thread_.join();
+  }
+}
+
+std::size_t RestStandIn::GetRequestCount() const noexcept {
+  return request_count_.load();
+}
+
+std::size_t RestStandIn::GetRetryCount() const noexcept {
+  return retry_count_.load();
+}
+
+void RestStandIn::SetMessageCreateObserver(std::function<void(dpp::message const&)> observer) noexcept {
+  message_create_observer_ = std::move(observer);
+}
+
+void RestStandIn::Respond(std::string const& route, dpp::command_completion_event_t&& callback, dpp::confirmable_t&& value, uint16_t const status) {
+  ++request_count_;
+  Attempt(route, std::move(callback), std::move(value), status);
+}
+
+void RestStandIn::Attempt(std::string route, dpp::command_completion_event_t callback, dpp::confirmable_t value, uint16_t const status) {
+  auto const now = std::chrono::steady_clock::now();
+  if (auto const retry_after = ConsumeRateLimit(route)) {
+    ++retry_count_;
+    logger_.Debug("Route '{}' is rate limited, retrying in {} ms", route, std::chrono::duration_cast<std::chrono::milliseconds>(*retry_after).count());
+    Enqueue(now + latency_ + *retry_after, [this, route = std::move(route), callback = std::move(callback), value = std::move(value), status]() {
+      Attempt(route, callback, value, status);
+    });
+    return;
+  }
+
+  if (!callback) {
+    return;
+  }
+
+  dpp::confirmation_callback_t confirmation;
+  confirmation.value = std::move(value);
+  confirmation.http_info.status = status;
+  Enqueue(now + latency_, [callback = std::move(callback), confirmation = std::move(confirmation)]() { callback(confirmation); });
+}
+
+void RestStandIn::Enqueue(std::chrono::steady_clock::time_point const due, std::function<void()> respond) {
+  {
+    std::scoped_lock<std::mutex> const mutex_lock(pending_responses_mutex_);
+    pending_responses_.push(PendingResponse{.due = due, .respond = std::move(respond)});
+  }
+  pending_responses_condition_.notify_one();
+}
+
+std::optional<std::chrono::steady_clock::duration> RestStandIn::ConsumeRateLimit(std::string const& route) {
+  if (0 == rate_limit_requests_) {
+    return std::nullopt;
+  }
+
+  auto const now = std::chrono::steady_clock::now();
+
+  std::scoped_lock<std::mutex> const mutex_lock(rate_limit_mutex_);
+
+  auto& [window_start, requests] = route_windows_[route];
+  if (now - window_start >= rate_limit_window_) {
+    window_start = now;
+    requests = 0;
+  }
+
+  if (++requests <= rate_limit_requests_) {
+    return std::nullopt;
+  }
+
+  return window_start + rate_limit_window_ - now;
+}
+
+dpp::message RestStandIn::StoreMessage(dpp::message message) {
+  std::scoped_lock<std::mutex> const mutex_lock(messages_mutex_);
+
+  message.id = next_snowflake_++;
+  messages_[message.id] = message;
+  if (messages_.size() > kMaxStoredMessages) {
+    messages_.erase(messages_.begin());
+  }
+
+  return message;
+}
+
+void RestStandIn::Run() {
+  std::unique_lock<std::mutex> mutex_lock(pending_responses_mutex_);
+  while (true) {
+    if (pending_responses_.empty()) {
+      if (stopping_) {
+        return;
+      }
+
+      pending_responses_condition_.wait(mutex_lock);
+      continue;
+    }
+
+    auto const due = pending_responses_.top().due;
+    if (std::chrono::steady_clock::now() < due) {
+      pending_responses_condition_.wait_until(mutex_lock, due);
+      continue;
+    }
+
+    auto const respond = pending_responses_.top().respond;
+    pending_responses_.pop();
+
+    mutex_lock.unlock();
+    respond();
+    mutex_lock.lock();
+  }
+}
\ No newline at end of file
@@ -0,0 +1,92 @@
+#pragma once
+
+#include <atomic>
+#include <chrono>
+#include <condition_variable>
+#include <cstddef>
+#include <functional>
+#include <map>
+#include <mutex>
+#include <optional>
+#include <queue>
+#include <string>
+#include <thread>
+#include <vector>
+
+#include <dpp/dpp.h>
+
+#include "logger/logger_factory.h"
+#include "rest/rest.h"
+
+// Offline replacement for the Discord REST API. Answers every call with a canned response after
+// the configured latency. A call over its route's budget gets a 429 and, as DPP does with the live
+// API, is sent again once its retry_after has passed, so handlers only see the final response.
+class RestStandIn final : public Rest {
+public:
+  ~RestStandIn() override;
+
+  RestStandIn();
+
+  void GuildGetMembers(dpp::snowflake guild_id, uint16_t limit, dpp::snowflake after, dpp::command_completion_event_t callback) override;
+  void GuildMemberAddRole(dpp::snowflake guild_id, dpp::snowflake user_id, dpp::snowflake role_id, dpp::command_completion_event_t callback) override;
+  void GuildMemberRemoveRole(dpp::snowflake guild_id, dpp::snowflake user_id, dpp::snowflake role_id, dpp::command_completion_event_t callback) override;
+  void MessageCreate(dpp::message const& message, dpp::command_completion_event_t callback) override;
+  void MessageEdit(dpp::message const& message, dpp::command_completion_event_t callback) override;
+  void MessageDelete(dpp::snowflake message_id, dpp::snowflake channel_id, dpp::command_completion_event_t callback) override;
+  void MessageGet(dpp::snowflake message_id, dpp::snowflake channel_id, dpp::command_completion_event_t callback) override;
+  void MessagesGet(dpp::snowflake channel_id, dpp::snowflake around, dpp::snowflake before, dpp::snowflake after, uint64_t limit, dpp::command_completion_event_t callback) override;
+  void MessageAddReaction(dpp::snowflake message_id, dpp::snowflake channel_id, std::string const& reaction, dpp::command_completion_event_t callback) override;
+  void CreateDmChannel(dpp::snowflake user_id, dpp::command_completion_event_t callback) override;
+
+  void Close() noexcept override;
+
+  std::size_t GetRequestCount() const noexcept;
+  std::size_t GetRetryCount() const noexcept;
+
+  // Called with every message posted, as the request arrives. Set it before any call is made.
+  void SetMessageCreateObserver(std::function<void(dpp::message const&)> observer) noexcept;
+
+private:
+  struct PendingResponse {
+    std::chrono::steady_clock::time_point due;
+    std::function<void()> respond;
+
+    bool operator>(PendingResponse const& other) const noexcept {
+      return due > other.due;
+    }
+  };
+
+  void Respond(std::string const& route, dpp::command_completion_event_t&& callback, dpp::confirmable_t&& value, uint16_t status = 200);
+  void Attempt(std::string route, dpp::command_completion_event_t callback, dpp::confirmable_t value, uint16_t status);
+  void Enqueue(std::chrono::steady_clock::time_point due, std::function<void()> respond);
+  // Returns the retry_after of the 429 answering the call, or nothing when it fits the route's budget.
+  std::optional<std::chrono::steady_clock::duration> ConsumeRateLimit(std::string const& route);
+  dpp::message StoreMessage(dpp::message message);
+  void Run();
+
+private:
+  Logger const logger_ = LoggerFactory::Get().Create("REST Stand-In");
+
+  std::chrono::milliseconds const latency_;
+  std::size_t const rate_limit_requests_;
+  std::chrono::milliseconds const rate_limit_window_;
+
+  std::mutex messages_mutex_;
+  std::map<dpp::snowflake, dpp::message> messages_;
+  uint64_t next_snowflake_ = 1ULL << 42;
+
+  std::mutex rate_limit_mutex_;
+  std::map<std::string, std::pair<std::chrono::steady_clock::time_point, std::size_t>> route_windows_;
+
+  std::mutex pending_responses_mutex_;
+  std::condition_variable pending_responses_condition_;
+  std::priority_queue<PendingResponse, std::vector<PendingResponse>, std::greater<>> pending_responses_;
+  bool stopping_{};
+
+  std::function<void(dpp::message const&)> message_create_observer_;
+
+  std::atomic<std::size_t> request_count_{};
+  std::atomic<std::size_t> retry_count_{};
+
+  std::thread thread_;
+};
\ No newline at end of file
@@ -0,0 +1,104 @@
+#include "stream_benchmark.h"
+
+#include <algorithm>
+#include <array>
+#include <format>
+#include <ranges>
+#include <string>
+#include <utility>
+
+#include "presence/stream_matcher.h"
+
+namespace {
+  auto constexpr kCorpusActivities = 10000ULL;
+  auto constexpr kPasses = 20ULL;
+
+  // Each rule is checked field by field with exact comparisons and substring searches.
+  bool ScanMatches(std::vector<Settings::StreamRule> const& rules, dpp::activity const& activity) {
+    if (dpp::activity_type::at_streaming != activity.type) {
+      return false;
+    }
+
+    return std::ranges::any_of(rules, [&activity](auto const& rule) {
+      auto const contains = [](std::string const& field) { return [&field](auto const& pattern) { return field.contains(pattern); }; };
+      return (activity.name == rule.platform) &&
+             (rule.games.empty() || std::ranges::contains(rule.games, activity.state)) &&
+             (rule.keywords.empty() || std::ranges::any_of(rule.keywords, contains(activity.details))) &&
+             std::ranges::none_of(rule.exclusions, contains(activity.state)) &&
+             std::ranges::none_of(rule.exclusions, contains(activity.details));
+    });
+  }
+
+  // Nanoseconds per activity over several passes of the corpus, and how many activities matched.
+  template <typename Matches>
+  std::pair<double, std::size_t> Time(std::vector<dpp::activity> const& corpus, Matches const& matches) {
+    std::size_t matched{};
+    auto const start = std::chrono::steady_clock::now();
+    for (auto pass = 0ULL; pass < kPasses; ++pass) {
+      matched = static_cast<std::size_t>(std::ranges::count_if(corpus, matches));
+    }
+    auto const elapsed = std::chrono::duration<double, std::nano>(std::chrono::steady_clock::now() - start).count();
+    return {elapsed / static_cast<double>(kPasses * corpus.size()), matched};
+  }
+}
+
+bool StreamBenchmark::Run() const {
+  auto const corpus = CreateCorpus();
+
+  auto const& configured_rules = Settings::Get().GetStreamRules();
+  auto padded_rules = configured_rules;
+  for (auto romhack = 0ULL; padded_rules.size() < StreamMatcher::kMaxRules; ++romhack) {
+    padded_rules.push_back(Settings::StreamRule{.platform = "Twitch", .games = {"Super Mario 64"}, .keywords = {std::format("Romhack {}", romhack)}, .exclusions = {"Reupload"}});
+  }
+
+  auto const configured_agree = Compare(configured_rules, corpus);
+  auto const padded_agree = Compare(padded_rules, corpus);
+  return configured_agree && padded_agree;
+}
+
+bool StreamBenchmark::Compare(std::vector<Settings::StreamRule> const& rules, std::vector<dpp::activity> const& corpus) const {
+  StreamMatcher const stream_matcher(rules);
+
+  auto const [scan_nanoseconds, scan_matched] = ::Time(corpus, [&rules](auto const& activity) { return ::ScanMatches(rules, activity); });
+  auto const [matcher_nanoseconds, matcher_matched] = ::Time(corpus, [&stream_matcher](auto const& activity) { return stream_matcher.Matches(activity); });
+
+  auto const disagreements = std::ranges::count_if(corpus, [&rules, &stream_matcher](auto const& activity) { return ::ScanMatches(rules, activity) != stream_matcher.Matches(activity); });
+  logger_.Info("{} rules over {} activities: substring scan {:.0f} ns per activity, automaton {:.0f} ns per activity ({:.1f}x). {} and {} matched, {} disagreements",
+               rules.size(), corpus.size(), scan_nanoseconds, matcher_nanoseconds, (matcher_nanoseconds > 0.0) ? (scan_nanoseconds / matcher_nanoseconds) : 0.0,
+               scan_matched, matcher_matched, disagreements);
+  return 0 == disagreements;
+}
+
+std::vector<dpp::activity> StreamBenchmark::CreateCorpus() {
+  struct Template {
+    dpp::activity_type type;
+    char const* name;
+    char const* state;
+    char const* details;
+  };
+
+  // Written with the case the rules use, since the substring scan is case-sensitive and the automaton isn't.
+  auto constexpr kTemplates = std::array{
+    Template{dpp::activity_type::at_streaming, "Twitch", "Super Mario 64", "120 Star PB attempts"},
+    Template{dpp::activity_type::at_streaming, "Twitch", "Super Mario 64", "Romhack 17 blind run, first time playing"},
+    Template{dpp::activity_type::at_streaming, "Twitch", "Super Mario 64", "Romhack 40 Reupload of yesterday's run"},
+    Template{dpp::activity_type::at_streaming, "Twitch", "Just Chatting", "Talking about the SM64 tournament"},
+    Template{dpp::activity_type::at_streaming, "Twitch", "The Legend of Zelda: Ocarina of Time", "Any% practice"},
+    Template{dpp::activity_type::at_streaming, "YouTube", "", "SM64 16 star practice with chat"},
+    Template{dpp::activity_type::at_streaming, "YouTube", "", "Minecraft survival episode"},
+    Template{dpp::activity_type::at_game, "Super Mario 64", "Star 1", "Bob-omb Battlefield"},
+    Template{dpp::activity_type::at_custom, "Custom Status", "Grinding the 120 star category", ""},
+    Template{dpp::activity_type::at_listening, "Spotify", "Koji Kondo", "Dire, Dire Docks"}
+  };
+
+  std::vector<dpp::activity> corpus(kCorpusActivities);
+  for (std::size_t i = 0; i < corpus.size(); ++i) {
+    auto const& activity_template = kTemplates[i % kTemplates.size()];
+    corpus[i].type = activity_template.type;
+    corpus[i].name = activity_template.name;
+    corpus[i].state = activity_template.state;
+    corpus[i].details = std::format("{} #{}", activity_template.details, i);
+  }
+
+  return corpus;
+}
\ No newline at end of file
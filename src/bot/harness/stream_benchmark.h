@@ -0,0 +1,29 @@
+#pragma once
+
+#include <chrono>
+#include <vector>
+
+#include <dpp/dpp.h>
+
+#include "logger/logger_factory.h"
+#include "settings/settings.h"
+
+// Matches a corpus of presence activities against the configured stream rules, and against the
+// configured rules padded to the most StreamMatcher takes, two ways: with a substring scan per rule,
+// the way streams were detected before the rules were compiled, and with the StreamMatcher automaton.
+class StreamBenchmark final {
+public:
+  StreamBenchmark() = default;
+  ~StreamBenchmark() = default;
+
+  // Returns true when both ways agree on every activity of the corpus.
+  bool Run() const;
+
+private:
+  bool Compare(std::vector<Settings::StreamRule> const& rules, std::vector<dpp::activity> const& corpus) const;
+
+  static std::vector<dpp::activity> CreateCorpus();
+
+private:
+  Logger const logger_ = LoggerFactory::Get().Create("Stream Benchmark");
+};
\ No newline at end of file
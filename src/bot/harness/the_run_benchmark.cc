@@ -0,0 +1,64 @@
+#include "the_run_benchmark.h"
+
+#include <chrono>
+#include <format>
+#include <memory>
+#include <string>
+#include <string_view>
+#include <thread>
+
+#include <dpp/dpp.h>
+
+#include "metrics/latency_histogram.h"
+#include "rest_stand_in.h"
+#include "settings/settings.h"
+#include "the_run/the_run.h"
+#include "the_run_feed_stand_in.h"
+
+bool TheRunBenchmark::Run() const {
+  using namespace std::chrono_literals;
+
+  auto feed_settings = Settings::Get().GetHarnessSettings().the_run_feed;
+  feed_settings.port = 0;
+  if (0 == feed_settings.duration.count()) {
+    feed_settings.duration = 10s;
+  }
+
+  TheRunFeedStandIn feed(feed_settings);
+  LatencyHistogram ping_latency;
+  auto const rest = std::make_shared<RestStandIn>();
+  rest->SetMessageCreateObserver([&feed, &ping_latency](dpp::message const& message) {
+    auto constexpr kRunnerPrefix = std::string_view("**Runner: ");
+    auto const user_start = message.content.find(kRunnerPrefix);
+    auto const user_end = (std::string::npos == user_start) ? std::string::npos : message.content.find("**", user_start + kRunnerPrefix.size());
+    if (std::string::npos == user_end) {
+      return;
+    }
+
+    auto const user = message.content.substr(user_start + kRunnerPrefix.size(), user_end - user_start - kRunnerPrefix.size());
+    if (auto const send_time = feed.TakeQualifyingSendTime(user)) {
+      ping_latency.Record(std::chrono::steady_clock::now() - *send_time);
+    }
+  });
+
+  auto const benchmark_start = std::chrono::steady_clock::now();
+  TheRun the_run(rest, std::format("ws://127.0.0.1:{}", feed.GetPort()));
+  feed.WaitFinished(feed_settings.duration + 30s);
+  auto const feed_seconds = std::chrono::duration<double>(std::chrono::steady_clock::now() - benchmark_start).count();
+
+  auto const drain_deadline = std::chrono::steady_clock::now() + 5s;
+  auto const feed_stats = feed.GetStats();
+  while (((the_run.GetStats().payloads < feed_stats.sent) || (ping_latency.GetCount() < feed_stats.qualifying)) && (std::chrono::steady_clock::now() < drain_deadline)) {
+    std::this_thread::sleep_for(10ms);
+  }
+
+  auto const the_run_stats = the_run.GetStats();
+  logger_.Info("Processed {} of {} payloads in {:.3f} s ({:.1f} payloads/s), {} of {} qualifying payloads pinged",
+               the_run_stats.payloads, feed_stats.sent, feed_seconds, static_cast<double>(the_run_stats.payloads) / feed_seconds, ping_latency.GetCount(), feed_stats.qualifying);
+  logger_.Info("Qualifying payload to post on the REST stand-in p50 {} us, p99 {} us, max {} us",
+               ping_latency.GetPercentile(0.50).count(), ping_latency.GetPercentile(0.99).count(), ping_latency.GetMax().count());
+  if (0 == the_run_stats.pings) {
+    logger_.Warn("No pings were posted, check that a guild has a pacepals role and that the_run.thresholds covers every category");
+  }
+  return (the_run_stats.payloads == feed_stats.sent) && (ping_latency.GetCount() == feed_stats.qualifying);
+}
\ No newline at end of file
@@ -0,0 +1,18 @@
+#pragma once
+
+#include "logger/logger_factory.h"
+
+// Streams the feed stand-in to TheRun over a local WebSocket, with pings posted to the REST
+// stand-in, and reports how fast payloads were processed and how long each qualifying payload
+// took to become a post.
+class TheRunBenchmark final {
+public:
+  TheRunBenchmark() = default;
+  ~TheRunBenchmark() = default;
+
+  // Returns true when every payload was processed and every qualifying one was pinged.
+  bool Run() const;
+
+private:
+  Logger const logger_ = LoggerFactory::Get().Create("The Run Benchmark");
+};
\ No newline at end of file
@@ -0,0 +1,226 @@
+#include "the_run_feed_stand_in.h"
+
+#include <algorithm>
+#include <array>
+#include <cmath>
+#include <format>
+#include <fstream>
+#include <utility>
+#include <string_view>
+
+#include <boost/asio/co_spawn.hpp>
+#include <boost/asio/detached.hpp>
+#include <boost/asio/steady_timer.hpp>
+#include <boost/asio/use_awaitable.hpp>
+#include <boost/beast/core.hpp>
+#include <boost/beast/websocket.hpp>
+#include <nlohmann/json.hpp>
+
+#include "the_run/payload_parser.h"
+
+namespace {
+  auto constexpr kSplitsPerRun = 20ULL;
+  auto constexpr kOtherGamesBpt = 3600000LL;
+
+  struct Category {
+    std::string_view name;
+    Settings::Categories category;
+  };
+
+  auto constexpr kCategories = std::array{
+    Category{"0 Star", Settings::Categories::k0Star},
+    Category{"1 Star", Settings::Categories::k1Star},
+    Category{"16 Star", Settings::Categories::k16Star},
+    Category{"70 Star", Settings::Categories::k70Star},
+    Category{"120 Star", Settings::Categories::k120Star}
+  };
+
+  auto constexpr kOtherGames = std::array{std::string_view("Celeste"), std::string_view("Super Mario Odyssey"), std::string_view("Hollow Knight")};
+}
+
+TheRunFeedStandIn::TheRunFeedStandIn(Settings::TheRunFeedSettings const& settings) :
+  settings_(settings),
+  acceptor_(io_context_, boost::asio::ip::tcp::endpoint(boost::asio::ip::address_v4::loopback(), settings.port)) {
+  if (!settings_.recording_path.empty()) {
+    std::ifstream recording_file(settings_.recording_path);
+    for (std::string line; std::getline(recording_file, line);) {
+      if (!line.empty()) {
+        recorded_payloads_.push_back(std::move(line));
+      }
+    }
+
+    if (recorded_payloads_.empty()) {
+      logger_.Error("No payloads in The Run recording '{}', generating payloads instead", settings_.recording_path);
+    }
+  }
+
+  auto const runners = std::max<std::size_t>(1, settings_.runners);
+  auto const sm64_runners = static_cast<std::size_t>(std::lround(std::clamp(settings_.sm64_share, 0.0, 1.0) * static_cast<double>(runners)));
+  for (std::size_t i = 0; i < runners; ++i) {
+    Runner runner;
+    runner.user = std::format("runner{}", i);
+    if (i < sm64_runners) {
+      auto const& category = kCategories[i % kCategories.size()];
+      runner.game = "Super Mario 64";
+      runner.category = std::string(category.name);
+      runner.threshold_bpt = Settings::Get().GetTheRunThresholds(category.category).bpt;
+    } else {
+      runner.game = std::string(kOtherGames[i % kOtherGames.size()]);
+      runner.category = "Any%";
+      runner.threshold_bpt = kOtherGamesBpt;
+    }
+    StartRun(runner);
+    runners_.push_back(std::move(runner));
+  }
+
+  boost::asio::co_spawn(io_context_, Listen(), boost::asio::detached);
+  thread_ = std::thread([this]() { io_context_.run(); });
+
+  logger_.Info("Serving The Run feed on ws://127.0.0.1:{} at {} payloads/s from {}", GetPort(), settings_.payloads_per_second,
+               recorded_payloads_.empty() ? std::format("{} generated runners, {} of them playing SM64", runners, sm64_runners) : std::format("'{}'", settings_.recording_path));
+}
+
+TheRunFeedStandIn::~TheRunFeedStandIn() {
+  io_context_.stop();
+  thread_.join();
+
+  auto const stats = GetStats();
+  logger_.Info("Sent {} The Run payloads, {} of them qualifying for a ping", stats.sent, stats.qualifying);
+}
+
+uint16_t TheRunFeedStandIn::GetPort() const noexcept {
+  return acceptor_.local_endpoint().port();
+}
+
+TheRunFeedStandIn::Stats TheRunFeedStandIn::GetStats() const noexcept {
+  std::scoped_lock<std::mutex> const mutex_lock(mutex_);
+  return Stats{.sent = sent_.load(), .qualifying = qualifying_.load(), .finished = finished_};
+}
+
+bool TheRunFeedStandIn::WaitFinished(std::chrono::steady_clock::duration const timeout) noexcept {
+  std::unique_lock<std::mutex> mutex_lock(mutex_);
+  return finished_condition_.wait_for(mutex_lock, timeout, [this]() { return finished_; });
+}
+
+std::optional<std::chrono::steady_clock::time_point> TheRunFeedStandIn::TakeQualifyingSendTime(std::string const& user) noexcept {
+  std::scoped_lock<std::mutex> const mutex_lock(mutex_);
+  auto const it_send_times = users_qualifying_send_times_.find(user);
+  if ((users_qualifying_send_times_.cend() == it_send_times) || it_send_times->second.empty()) {
+    return std::nullopt;
+  }
+
+  auto const send_time = it_send_times->second.front();
+  it_send_times->second.pop_front();
+  return send_time;
+}
+
+boost::asio::awaitable<void> TheRunFeedStandIn::Listen() {
+  while (true) {
+    auto socket = co_await acceptor_.async_accept(boost::asio::use_awaitable);
+    boost::asio::co_spawn(io_context_, Stream(std::move(socket)), boost::asio::detached);
+  }
+}
+
+boost::asio::awaitable<void> TheRunFeedStandIn::Stream(boost::asio::ip::tcp::socket socket) {
+  auto const payload_period = std::chrono::duration_cast<std::chrono::steady_clock::duration>(std::chrono::duration<double>(1.0 / std::max(settings_.payloads_per_second, 0.001)));
+
+  try {
+    boost::beast::websocket::stream<boost::beast::tcp_stream> web_socket(std::move(socket));
+    co_await web_socket.async_accept(boost::asio::use_awaitable);
+    web_socket.text(true);
+    logger_.Info("The Run feed client connected");
+
+    auto const stream_start = std::chrono::steady_clock::now();
+    auto const stream_end = (0 != settings_.duration.count()) ? (stream_start + settings_.duration) : std::chrono::steady_clock::time_point::max();
+    boost::asio::steady_timer pacing_timer(web_socket.get_executor());
+    for (uint64_t i = 0; (stream_start + (i * payload_period)) < stream_end; ++i) {
+      pacing_timer.expires_at(stream_start + (i * payload_period));
+      co_await pacing_timer.async_wait(boost::asio::use_awaitable);
+
+      auto const payload = NextPayload();
+      Track(payload, std::chrono::steady_clock::now());
+      co_await web_socket.async_write(boost::asio::buffer(payload), boost::asio::use_awaitable);
+      ++sent_;
+    }
+
+    co_await web_socket.async_close(boost::beast::websocket::close_code::normal, boost::asio::use_awaitable);
+  } catch (boost::beast::system_error const& error) {
+    logger_.Info("The Run feed client disconnected. Error '{}'", error.code().message());
+  }
+
+  {
+    std::scoped_lock<std::mutex> const mutex_lock(mutex_);
+    finished_ = true;
+  }
+  finished_condition_.notify_all();
+}
+
+std::string TheRunFeedStandIn::NextPayload() {
+  auto const payload_index = next_payload_++;
+  if (!recorded_payloads_.empty()) {
+    return recorded_payloads_[payload_index % recorded_payloads_.size()];
+  }
+
+  return GeneratePayload(runners_[payload_index % runners_.size()]);
+}
+
+std::string TheRunFeedStandIn::GeneratePayload(Runner& runner) {
+  if (kSplitsPerRun < ++runner.completed_splits) {
+    StartRun(runner);
+  }
+
+  auto splits_json = nlohmann::json::array();
+  for (auto split = 0ULL; split < kSplitsPerRun; ++split) {
+    auto const pb_split_time = (runner.pb * static_cast<long long>(split + 1)) / static_cast<long long>(kSplitsPerRun);
+    auto const split_time = (runner.best_possible * static_cast<long long>(split + 1)) / static_cast<long long>(kSplitsPerRun);
+    splits_json.push_back({
+      {"index", std::to_string(split)},
+      {"name", std::format("Split {}", split + 1)},
+      {"splitTime", (split < runner.completed_splits) ? nlohmann::json(split_time) : nlohmann::json(nullptr)},
+      {"pbSplitTime", pb_split_time}
+    });
+  }
+
+  auto const payload_json = nlohmann::json{
+    {"user", runner.user},
+    {"run", {
+      {"game", runner.game},
+      {"category", runner.category},
+      {"currentlyStreaming", true},
+      {"runPercentage", static_cast<double>(runner.completed_splits) / static_cast<double>(kSplitsPerRun)},
+      {"bestPossible", runner.best_possible},
+      {"pb", runner.pb},
+      {"sob", runner.best_possible - 1000},
+      {"emulator", 0 != (runner.attempt_count % 2)},
+      {"gameData", {
+        {"attemptCount", runner.attempt_count},
+        {"url", std::format("{}/{}", runner.user, runner.game)}
+      }},
+      {"splits", std::move(splits_json)}
+    }}
+  };
+  return payload_json.dump();
+}
+
+void TheRunFeedStandIn::StartRun(Runner& runner) {
+  // Best possible times spread a few percent around the threshold, so roughly half the runs are on
+  // pace once they are far enough along and the rest never are.
+  std::uniform_real_distribution<double> pace(0.97, 1.03);
+  runner.best_possible = std::llround(static_cast<double>(runner.threshold_bpt) * pace(random_engine_));
+  runner.pb = std::max(runner.best_possible, std::llround(static_cast<double>(runner.threshold_bpt) * 1.01));
+  runner.completed_splits = 0;
+  ++runner.attempt_count;
+}
+
+void TheRunFeedStandIn::Track(std::string const& payload, std::chrono::steady_clock::time_point const send_time) {
+  // Mirrors TheRun: a user is pinged on their first pingable payload and again only after a payload
+  // that is not.
+  auto const payload_parser = PayloadParser(payload);
+  auto& qualifying = users_qualifying_[payload_parser.GetUser()];
+  if (payload_parser.IsPingable() && !qualifying) {
+    ++qualifying_;
+    std::scoped_lock<std::mutex> const mutex_lock(mutex_);
+    users_qualifying_send_times_[payload_parser.GetUser()].push_back(send_time);
+  }
+  qualifying = payload_parser.IsPingable();
+}
\ No newline at end of file
@@ -0,0 +1,97 @@
+#pragma once
+
+#include <atomic>
+#include <chrono>
+#include <condition_variable>
+#include <cstddef>
+#include <cstdint>
+#include <deque>
+#include <map>
+#include <mutex>
+#include <optional>
+#include <random>
+#include <string>
+#include <thread>
+#include <utility>
+#include <vector>
+
+#include <boost/asio/awaitable.hpp>
+#include <boost/asio/io_context.hpp>
+#include <boost/asio/ip/tcp.hpp>
+
+#include "logger/logger_factory.h"
+#include "settings/settings.h"
+
+// Local stand-in for the therun.gg live feed. Serves plain WebSocket connections on localhost and
+// streams each one payloads at a fixed rate, either replayed from a recording (one JSON payload per
+// line, looped) or generated for a pool of runners. Generated runners play SM64 or other games in the
+// configured mix and climb through their runs with a best possible time around their category's
+// threshold, so some runs cross the ping thresholds and others never do. The send time of every
+// payload that should make the bot ping is kept for measuring how long the ping took.
+class TheRunFeedStandIn final {
+public:
+  struct Stats {
+    uint64_t sent{};
+    uint64_t qualifying{};
+    bool finished{};
+  };
+
+  TheRunFeedStandIn() = delete;
+  ~TheRunFeedStandIn();
+
+  TheRunFeedStandIn(Settings::TheRunFeedSettings const& settings);
+
+  TheRunFeedStandIn(TheRunFeedStandIn const&) = delete;
+  void operator=(TheRunFeedStandIn const&) = delete;
+
+  uint16_t GetPort() const noexcept;
+  Stats GetStats() const noexcept;
+
+  // Returns when the first connection's stream has ended, or after the timeout.
+  bool WaitFinished(std::chrono::steady_clock::duration timeout) noexcept;
+
+  // Send time of the oldest qualifying payload for the user not yet taken.
+  std::optional<std::chrono::steady_clock::time_point> TakeQualifyingSendTime(std::string const& user) noexcept;
+
+private:
+  struct Runner {
+    std::string user;
+    std::string game;
+    std::string category;
+    long long threshold_bpt{};
+    long long best_possible{};
+    long long pb{};
+    std::size_t attempt_count{};
+    std::size_t completed_splits{};
+  };
+
+  boost::asio::awaitable<void> Listen();
+  boost::asio::awaitable<void> Stream(boost::asio::ip::tcp::socket socket);
+
+  std::string NextPayload();
+  std::string GeneratePayload(Runner& runner);
+  void StartRun(Runner& runner);
+  void Track(std::string const& payload, std::chrono::steady_clock::time_point send_time);
+
+private:
+  Logger const logger_ = LoggerFactory::Get().Create("The Run Feed Stand-In");
+
+  Settings::TheRunFeedSettings const settings_;
+  std::vector<std::string> recorded_payloads_;
+  std::vector<Runner> runners_;
+  std::size_t next_payload_{};
+  std::mt19937 random_engine_ = std::mt19937(64);
+  std::map<std::string, bool> users_qualifying_;
+
+  std::atomic<uint64_t> sent_{};
+  std::atomic<uint64_t> qualifying_{};
+
+  mutable std::mutex mutex_;
+  std::condition_variable finished_condition_;
+  bool finished_{};
+  std::map<std::string, std::deque<std::chrono::steady_clock::time_point>> users_qualifying_send_times_;
+
+  boost::asio::io_context io_context_;
+  boost::asio::ip::tcp::acceptor acceptor_;
+  std::thread thread_;
+};
\ No newline at end of file
@@ -0,0 +1,26 @@
+#pragma once
+
+#include <chrono>
+#include <cstdint>
+#include <string>
+
+// Trace files start with kTraceMagic followed by one record per gateway event: varint microseconds
+// since the previous record, event type byte, varint payload length and the raw gateway payload.
+namespace trace {
+  inline constexpr char kTraceMagic[] = "SM64TRC1";
+
+  enum class EventType : uint8_t {
+    kReady = 0,
+    kMessageCreate = 1,
+    kMessageReactionAdd = 2,
+    kPresenceUpdate = 3,
+    kGuildMemberAdd = 4,
+    kGuildMemberRemove = 5
+  };
+
+  struct Event {
+    std::chrono::microseconds offset{};
+    EventType type{};
+    std::string payload;
+  };
+}
\ No newline at end of file
@@ -0,0 +1,62 @@
+#include "trace_reader.h"
+
+#include <format>
+#include <stdexcept>
+#include <string_view>
+
+TraceReader::TraceReader(std::string const& path) :
+  trace_file_(path, std::ios::binary) {
+  if (!trace_file_) {
+    throw std::runtime_error(std::format("Failed to open trace file '{}'", path));
+  }
+
+  std::string magic(sizeof(trace::kTraceMagic) - 1, '\0');
+  trace_file_.read(magic.data(), static_cast<std::streamsize>(magic.size()));
+  if (std::string_view(trace::kTraceMagic) != magic) {
+    throw std::runtime_error(std::format("File '{}' is not a gateway event trace", path));
+  }
+}
+
+std::optional<trace::Event> TraceReader::Next() {
+  auto const delta = ReadVarint();
+  if (!delta) {
+    return std::nullopt;
+  }
+
+  auto const type = trace_file_.get();
+  auto const size = ReadVarint();
+  if (std::char_traits<char>::eof() == type || !size) {
+    return std::nullopt;
+  }
+
+  offset_ += std::chrono::microseconds(*delta);
+
+  trace::Event event{
+    .offset = offset_,
+    .type = static_cast<trace::EventType>(type),
+    .payload = std::string(*size, '\0')
+  };
+  trace_file_.read(event.payload.data(), static_cast<std::streamsize>(*size));
+  if (!trace_file_) {
+    return std::nullopt;
+  }
+
+  return event;
+}
+
+std::optional<uint64_t> TraceReader::ReadVarint() {
+  uint64_t value{};
+  for (auto shift = 0; shift < 64; shift += 7) {
+    auto const byte = trace_file_.get();
+    if (std::char_traits<char>::eof() == byte) {
+      return std::nullopt;
+    }
+
+    value |= static_cast<uint64_t>(byte & 0x7F) << shift;
+    if (0 == (byte & 0x80)) {
+      return value;
+    }
+  }
+
+  return std::nullopt;
+}
\ No newline at end of file
@@ -0,0 +1,27 @@
+#pragma once
+
+#include <chrono>
+#include <cstdint>
+#include <fstream>
+#include <optional>
+#include <string>
+
+#include "trace.h"
+
+class TraceReader final {
+public:
+  TraceReader() = delete;
+  ~TraceReader() = default;
+
+  TraceReader(std::string const& path);
+
+  std::optional<trace::Event> Next();
+
+private:
+  std::optional<uint64_t> ReadVarint();
+
+private:
+  std::ifstream trace_file_;
+
+  std::chrono::microseconds offset_{};
+};
\ No newline at end of file
@@ -0,0 +1,48 @@
+#include "trace_recorder.h"
+
+#include <format>
+#include <stdexcept>
+
+TraceRecorder::TraceRecorder(std::string const& path) :
+  trace_file_(path, std::ios::binary | std::ios::trunc) {
+  if (!trace_file_) {
+    throw std::runtime_error(std::format("Failed to open trace file '{}'", path));
+  }
+
+  trace_file_.write(trace::kTraceMagic, sizeof(trace::kTraceMagic) - 1);
+
+  logger_.Info("Recording gateway events to '{}'", path);
+}
+
+TraceRecorder::~TraceRecorder() {
+  trace_file_.flush();
+  logger_.Info("Recorded {} gateway events", recorded_events_);
+}
+
+void TraceRecorder::Record(trace::EventType const type, std::string const& payload) noexcept {
+  auto const now = std::chrono::steady_clock::now();
+
+  std::scoped_lock<std::mutex> const mutex_lock(trace_file_mutex_);
+
+  WriteVarint(static_cast<uint64_t>(std::chrono::duration_cast<std::chrono::microseconds>(now - last_record_time_).count()));
+  trace_file_.put(static_cast<char>(type));
+  WriteVarint(payload.size());
+  trace_file_.write(payload.data(), static_cast<std::streamsize>(payload.size()));
+
+  if (!trace_file_) {
+    logger_.Error("Failed to record gateway event of type '{}'", static_cast<int>(type));
+    trace_file_.clear();
+    return;
+  }
+
+  last_record_time_ = now;
+  ++recorded_events_;
+}
+
+void TraceRecorder::WriteVarint(uint64_t value) {
+  while (value >= 0x80) {
+    trace_file_.put(static_cast<char>((value & 0x7F) | 0x80));
+    value >>= 7;
+  }
+  trace_file_.put(static_cast<char>(value));
+}
\ No newline at end of file
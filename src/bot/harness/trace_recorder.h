@@ -0,0 +1,33 @@
+#pragma once
+
+#include <chrono>
+#include <cstddef>
+#include <cstdint>
+#include <fstream>
+#include <mutex>
+#include <string>
+
+#include "logger/logger_factory.h"
+#include "trace.h"
+
+class TraceRecorder final {
+public:
+  TraceRecorder() = delete;
+  ~TraceRecorder();
+
+  TraceRecorder(std::string const& path);
+
+  void Record(trace::EventType type, std::string const& payload) noexcept;
+
+private:
+  void WriteVarint(uint64_t value);
+
+private:
+  Logger const logger_ = LoggerFactory::Get().Create("Trace Recorder");
+
+  std::ofstream trace_file_;
+  std::mutex trace_file_mutex_;
+
+  std::chrono::steady_clock::time_point last_record_time_ = std::chrono::steady_clock::now();
+  std::size_t recorded_events_{};
+};
\ No newline at end of file
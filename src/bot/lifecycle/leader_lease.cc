@@ -0,0 +1,84 @@
+#include "leader_lease.h"
+
+#include <string>
+#include <utility>
+
+#include <fcntl.h>
+#include <sys/file.h>
+#include <unistd.h>
+
+LeaderLease::LeaderLease(std::string path) noexcept :
+  path_(std::move(path)) {
+  file_descriptor_ = open(path_.c_str(), O_RDWR | O_CREAT | O_CLOEXEC, 0644);
+  if (-1 == file_descriptor_) {
+    logger_.Error("Failed to open leader lock '{}', this instance will lead without coordinating with others", path_);
+  }
+}
+
+LeaderLease::~LeaderLease() {
+  Release();
+  if (-1 != file_descriptor_) {
+    close(file_descriptor_);
+  }
+}
+
+bool LeaderLease::TryAcquire() noexcept {
+  std::scoped_lock<std::mutex> const mutex_lock(mutex_);
+  return Lock();
+}
+
+bool LeaderLease::Acquire(std::chrono::milliseconds const poll_interval) noexcept {
+  std::unique_lock<std::mutex> mutex_lock(mutex_);
+  while (!Lock()) {
+    if (cancel_condition_.wait_for(mutex_lock, poll_interval, [this]() { return cancelled_; })) {
+      return false;
+    }
+  }
+  return true;
+}
+
+void LeaderLease::Release() noexcept {
+  std::scoped_lock<std::mutex> const mutex_lock(mutex_);
+  if (!held_) {
+    return;
+  }
+
+  held_ = false;
+  if (-1 != file_descriptor_) {
+    flock(file_descriptor_, LOCK_UN);
+  }
+}
+
+void LeaderLease::Cancel() noexcept {
+  {
+    std::scoped_lock<std::mutex> const mutex_lock(mutex_);
+    cancelled_ = true;
+  }
+  cancel_condition_.notify_all();
+}
+
+bool LeaderLease::IsHeld() const noexcept {
+  std::scoped_lock<std::mutex> const mutex_lock(mutex_);
+  return held_;
+}
+
+bool LeaderLease::Lock() noexcept {
+  if (held_ || (-1 == file_descriptor_)) {
+    held_ = true;
+    return true;
+  }
+
+  if (0 != flock(file_descriptor_, LOCK_EX | LOCK_NB)) {
+    return false;
+  }
+
+  // The holder's pid is only informational, for whoever looks at the lock file.
+  auto const pid = std::to_string(getpid()).append("\n");
+  if ((0 != ftruncate(file_descriptor_, 0)) || (static_cast<ssize_t>(pid.size()) != pwrite(file_descriptor_, pid.data(), pid.size(), 0))) {
+    logger_.Warn("Failed to write pid to leader lock '{}'", path_);
+  }
+
+  held_ = true;
+  logger_.Info("Acquired leader lock '{}'", path_);
+  return true;
+}
\ No newline at end of file
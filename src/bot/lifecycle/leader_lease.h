@@ -0,0 +1,43 @@
+#pragma once
+
+#include <chrono>
+#include <condition_variable>
+#include <mutex>
+#include <string>
+
+#include "logger/logger_factory.h"
+
+// Leadership among bot processes that share the same state files, held as an exclusive flock on a
+// lock file. The kernel drops the lock as soon as its holder exits for any reason, crashes
+// included, so a standby polling the lock takes over without waiting for a lease to expire.
+class LeaderLease final {
+public:
+  LeaderLease() = delete;
+  ~LeaderLease();
+
+  LeaderLease(std::string path) noexcept;
+
+  LeaderLease(LeaderLease const&) = delete;
+  void operator=(LeaderLease const&) = delete;
+
+  bool TryAcquire() noexcept;
+  bool Acquire(std::chrono::milliseconds poll_interval) noexcept;
+  void Release() noexcept;
+  void Cancel() noexcept;
+
+  bool IsHeld() const noexcept;
+
+private:
+  bool Lock() noexcept;
+
+private:
+  Logger const logger_ = LoggerFactory::Get().Create("Leader Lease");
+
+  std::string const path_;
+  int file_descriptor_ = -1;
+
+  mutable std::mutex mutex_;
+  std::condition_variable cancel_condition_;
+  bool held_{};
+  bool cancelled_{};
+};
\ No newline at end of file
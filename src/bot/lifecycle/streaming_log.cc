@@ -0,0 +1,93 @@
+#include "streaming_log.h"
+
+#include <filesystem>
+#include <map>
+#include <utility>
+
+#include <nlohmann/json.hpp>
+
+StreamingLog::StreamingLog(std::string const& log_path) noexcept :
+  log_path_(log_path) {
+
+}
+
+std::vector<StreamingLog::Stream> StreamingLog::Load() const noexcept {
+  std::map<std::pair<dpp::snowflake, dpp::snowflake>, Stream> guilds_users_ids_and_streams;
+  std::ifstream log_file(log_path_);
+  for (std::string line; std::getline(log_file, line);) {
+    try {
+      auto const stream_json = nlohmann::json::parse(line);
+      auto stream = Stream{
+        .guild_id = dpp::snowflake(stream_json["guild_id"].get<uint64_t>()),
+        .user_id = dpp::snowflake(stream_json["user_id"].get<uint64_t>()),
+        .message_id = dpp::snowflake(stream_json["message_id"].get<uint64_t>()),
+        .content = stream_json.value("content", std::string())
+      };
+      auto const guild_user_ids = std::pair{stream.guild_id, stream.user_id};
+      if (stream.message_id.empty()) {
+        guilds_users_ids_and_streams.erase(guild_user_ids);
+      } else {
+        guilds_users_ids_and_streams.insert_or_assign(guild_user_ids, std::move(stream));
+      }
+    } catch (nlohmann::json::exception const& json_exception) {
+      logger_.Warn("Skipping unreadable streaming log line '{}'. Exception: '{}'", line, json_exception.what());
+    }
+  }
+
+  std::vector<Stream> streams;
+  for (auto& [guild_user_ids, stream] : guilds_users_ids_and_streams) {
+    streams.push_back(std::move(stream));
+  }
+  logger_.Info("Loaded {} live streams from '{}'", streams.size(), log_path_);
+  return streams;
+}
+
+void StreamingLog::Open(std::vector<Stream> const& streams) noexcept {
+  std::scoped_lock<std::mutex> const mutex_lock(mutex_);
+
+  // Written aside and renamed over the log, so a crash while compacting leaves the old log whole.
+  auto const compacted_path = log_path_ + ".tmp";
+  log_.open(compacted_path, std::ios::trunc);
+  for (auto const& stream : streams) {
+    Append(stream);
+  }
+  log_.close();
+
+  std::error_code rename_error;
+  std::filesystem::rename(compacted_path, log_path_, rename_error);
+  if (rename_error) {
+    logger_.Error("Failed to replace streaming log '{}'. Error: '{}'", log_path_, rename_error.message());
+  }
+
+  log_.open(log_path_, std::ios::app);
+  if (!log_) {
+    logger_.Error("Failed to open streaming log '{}', a standby will sweep away the streams announced from now on", log_path_);
+  }
+}
+
+void StreamingLog::Record(Stream const& stream) noexcept {
+  std::scoped_lock<std::mutex> const mutex_lock(mutex_);
+  Append(stream);
+}
+
+void StreamingLog::Erase(dpp::snowflake const guild_id, dpp::snowflake const user_id) noexcept {
+  std::scoped_lock<std::mutex> const mutex_lock(mutex_);
+  Append(Stream{.guild_id = guild_id, .user_id = user_id, .message_id = dpp::snowflake{}, .content = std::string()});
+}
+
+void StreamingLog::Append(Stream const& stream) noexcept {
+  if (!log_.is_open()) {
+    return;
+  }
+
+  auto const stream_json = nlohmann::json{
+    {"guild_id", static_cast<uint64_t>(stream.guild_id)},
+    {"user_id", static_cast<uint64_t>(stream.user_id)},
+    {"message_id", static_cast<uint64_t>(stream.message_id)},
+    {"content", stream.content}
+  };
+  log_ << stream_json.dump() << '\n' << std::flush;
+  if (!log_) {
+    logger_.Error("Failed to append stream of user '{}' to the streaming log", stream.user_id.str());
+  }
+}
\ No newline at end of file
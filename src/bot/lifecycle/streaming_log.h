@@ -0,0 +1,48 @@
+#pragma once
+
+#include <fstream>
+#include <mutex>
+#include <string>
+#include <vector>
+
+#include <dpp/dpp.h>
+
+#include "logger/logger_factory.h"
+
+// Streams the leader has announced, so a standby taking over adopts their messages and roles
+// instead of sweeping them away and announcing every stream again. Announcements, edits and stops
+// are appended to a log of JSON lines, which the leader rewrites with only the live streams when
+// it starts.
+class StreamingLog final {
+public:
+  struct Stream {
+    dpp::snowflake guild_id;
+    dpp::snowflake user_id;
+    dpp::snowflake message_id;
+    std::string content;
+  };
+
+  StreamingLog() = delete;
+  ~StreamingLog() = default;
+
+  StreamingLog(std::string const& log_path) noexcept;
+
+  // Reads the streams still live at the end of the log.
+  std::vector<Stream> Load() const noexcept;
+  // Rewrites the log with the given streams and appends to it from then on. Only the leader opens
+  // the log, so a standby never writes to it.
+  void Open(std::vector<Stream> const& streams) noexcept;
+
+  void Record(Stream const& stream) noexcept;
+  void Erase(dpp::snowflake guild_id, dpp::snowflake user_id) noexcept;
+
+private:
+  void Append(Stream const& stream) noexcept;
+
+private:
+  Logger const logger_ = LoggerFactory::Get().Create("Streaming Log");
+
+  std::string const log_path_;
+  std::ofstream log_;
+  std::mutex mutex_;
+};
\ No newline at end of file
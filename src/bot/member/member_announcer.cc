@@ -0,0 +1,200 @@
+#include "member_announcer.h"
+
+#include <algorithm>
+#include <future>
+#include <iterator>
+#include <utility>
+
+#include "settings/settings.h"
+
+namespace {
+  auto constexpr kMaxMessageLength = std::size_t{2000};
+  auto constexpr kDeadlineCheckInterval = std::chrono::milliseconds(100);
+}
+
+MemberAnnouncer::MemberAnnouncer(std::shared_ptr<Rest> rest) :
+  rest_(std::move(rest)),
+  burst_threshold_(Settings::Get().GetUpdatesSettings().burst_threshold),
+  burst_window_(Settings::Get().GetUpdatesSettings().burst_window),
+  thread_(&MemberAnnouncer::Run, this) {
+
+}
+
+MemberAnnouncer::~MemberAnnouncer() {
+  if (thread_.joinable()) {
+    Stop(std::chrono::steady_clock::now());
+  }
+}
+
+void MemberAnnouncer::AnnounceJoin(dpp::snowflake const guild_id, dpp::snowflake const user_id) {
+  Announce(guild_id, std::format("**{}** acabou de entrar no servidor.", dpp::user::get_mention(user_id)));
+}
+
+void MemberAnnouncer::AnnounceLeave(dpp::snowflake const guild_id, dpp::snowflake const user_id) {
+  Announce(guild_id, std::format("**{}** acabou de sair no servidor.", dpp::user::get_mention(user_id)));
+}
+
+void MemberAnnouncer::Stop(std::chrono::steady_clock::time_point const deadline) {
+  {
+    std::scoped_lock<std::mutex> const mutex_lock(guild_bursts_mutex_);
+    stopping_ = true;
+    stop_deadline_ = deadline;
+  }
+  guild_bursts_condition_.notify_all();
+
+  if (thread_.joinable()) {
+    thread_.join();
+  }
+}
+
+void MemberAnnouncer::Announce(dpp::snowflake const guild_id, std::string line) {
+  auto const* guild = Settings::Get().FindGuild(guild_id);
+  if (nullptr == guild) {
+    return;
+  }
+
+  auto const now = std::chrono::steady_clock::now();
+  {
+    std::scoped_lock<std::mutex> const mutex_lock(guild_bursts_mutex_);
+
+    auto& guild_burst = guild_bursts_[guild_id];
+    auto& recent_announcements = guild_burst.recent_announcements;
+    while (!recent_announcements.empty() && (now - recent_announcements.front() > burst_window_)) {
+      recent_announcements.pop_front();
+    }
+
+    // Nothing announced within the window means the last burst is over, so the next one starts
+    // its own message instead of appending to the old one.
+    if (recent_announcements.empty() && guild_burst.pending_lines.empty()) {
+      guild_burst.burst_message = dpp::message();
+      ++guild_burst.burst_generation;
+    }
+    recent_announcements.push_back(now);
+
+    auto const bursting = (recent_announcements.size() > burst_threshold_) || !guild_burst.pending_lines.empty();
+    if (bursting) {
+      if (guild_burst.pending_lines.empty()) {
+        guild_burst.flush_due = now + burst_window_;
+      }
+      guild_burst.pending_lines.push_back(std::move(line));
+      guild_bursts_condition_.notify_all();
+      return;
+    }
+  }
+
+  rest_->MessageCreate(dpp::message(guild->GetChannelId(Settings::Channels::kUpdates), line));
+}
+
+void MemberAnnouncer::Flush(dpp::snowflake const guild_id, std::vector<std::string> const& lines, dpp::message& burst_message) {
+  auto const* guild = Settings::Get().FindGuild(guild_id);
+  if (nullptr == guild) {
+    return;
+  }
+
+  logger_.Info("Announcing {} joins and leaves together in guild '{}'", lines.size(), guild_id.str());
+
+  auto const edit_burst_message = [this, &guild_id, &burst_message]() {
+    auto const edit_confirmation = Await([this, &burst_message](auto callback) { rest_->MessageEdit(burst_message, std::move(callback)); });
+    if (!edit_confirmation) {
+      logger_.Warn("Gave up editing join and leave message '{}' in guild '{}' at the shutdown deadline", burst_message.id.str(), guild_id.str());
+    } else if (edit_confirmation->is_error()) {
+      logger_.Error("Failed to edit join and leave message '{}' in guild '{}'. Error '{}'", burst_message.id.str(), guild_id.str(), edit_confirmation->get_error().human_readable);
+    }
+  };
+
+  auto burst_message_edited = false;
+  for (auto it_line = lines.cbegin(); lines.cend() != it_line; ++it_line) {
+    if (std::chrono::steady_clock::now() >= stop_deadline_.load()) {
+      logger_.Warn("Dropped {} joins and leaves in guild '{}' not announced by the shutdown deadline", std::distance(it_line, lines.cend()), guild_id.str());
+      break;
+    }
+
+    auto const& line = *it_line;
+    if (!burst_message.id.empty() && (burst_message.content.size() + 1 + line.size() <= ::kMaxMessageLength)) {
+      burst_message.content.append("\n").append(line);
+      burst_message_edited = true;
+      continue;
+    }
+
+    if (burst_message_edited) {
+      edit_burst_message();
+      burst_message_edited = false;
+    }
+
+    auto const create_confirmation = Await([this, guild, &line](auto callback) { rest_->MessageCreate(dpp::message(guild->GetChannelId(Settings::Channels::kUpdates), line), std::move(callback)); });
+    if (!create_confirmation || create_confirmation->is_error()) {
+      if (create_confirmation) {
+        logger_.Error("Failed to create join and leave message in guild '{}'. Error '{}'", guild_id.str(), create_confirmation->get_error().human_readable);
+      }
+      burst_message = dpp::message();
+      continue;
+    }
+
+    burst_message = create_confirmation->get<dpp::message>();
+  }
+
+  if (burst_message_edited) {
+    edit_burst_message();
+  }
+}
+
+std::optional<dpp::confirmation_callback_t> MemberAnnouncer::Await(std::function<void(dpp::command_completion_event_t)> const& call) const {
+  auto confirmation_promise = std::make_shared<std::promise<dpp::confirmation_callback_t>>();
+  auto confirmation_future = confirmation_promise->get_future();
+  call([confirmation_promise](dpp::confirmation_callback_t const& confirmation) { confirmation_promise->set_value(confirmation); });
+
+  // The deadline is checked while waiting too, as Stop can move it while a call is in flight.
+  while (std::future_status::ready != confirmation_future.wait_for(::kDeadlineCheckInterval)) {
+    if (std::chrono::steady_clock::now() >= stop_deadline_.load()) {
+      return std::nullopt;
+    }
+  }
+
+  try {
+    return confirmation_future.get();
+  } catch (std::future_error const&) {
+    // The completion was discarded without being called, as Rest::Close does.
+    return std::nullopt;
+  }
+}
+
+void MemberAnnouncer::Run() {
+  std::unique_lock<std::mutex> mutex_lock(guild_bursts_mutex_);
+  while (true) {
+    auto const it_next_flush = std::ranges::min_element(guild_bursts_, {}, [](auto const& guild_id_and_burst) {
+      auto const& guild_burst = guild_id_and_burst.second;
+      return guild_burst.pending_lines.empty() ? std::chrono::steady_clock::time_point::max() : guild_burst.flush_due;
+    });
+
+    auto const has_pending_lines = (guild_bursts_.end() != it_next_flush) && !it_next_flush->second.pending_lines.empty();
+    if (!has_pending_lines) {
+      if (stopping_) {
+        return;
+      }
+
+      guild_bursts_condition_.wait(mutex_lock);
+      continue;
+    }
+
+    auto& guild_burst = it_next_flush->second;
+    if (!stopping_ && (std::chrono::steady_clock::now() < guild_burst.flush_due)) {
+      guild_bursts_condition_.wait_until(mutex_lock, guild_burst.flush_due);
+      continue;
+    }
+
+    auto const guild_id = it_next_flush->first;
+    auto const lines = std::exchange(guild_burst.pending_lines, {});
+    auto burst_message = guild_burst.burst_message;
+    auto const burst_generation = guild_burst.burst_generation;
+
+    mutex_lock.unlock();
+    Flush(guild_id, lines, burst_message);
+    mutex_lock.lock();
+
+    // A burst that ended while this one was being posted already started a fresh message.
+    auto& flushed_burst = guild_bursts_[guild_id];
+    if (flushed_burst.burst_generation == burst_generation) {
+      flushed_burst.burst_message = std::move(burst_message);
+    }
+  }
+}
\ No newline at end of file
@@ -0,0 +1,70 @@
+#pragma once
+
+#include <atomic>
+#include <chrono>
+#include <condition_variable>
+#include <cstdint>
+#include <deque>
+#include <functional>
+#include <map>
+#include <memory>
+#include <mutex>
+#include <optional>
+#include <string>
+#include <thread>
+#include <vector>
+
+#include <dpp/dpp.h>
+
+#include "logger/logger_factory.h"
+#include "rest/rest.h"
+
+// Posts join and leave announcements to a guild's updates channel. While a guild sees at most
+// the burst threshold of joins and leaves within the burst window, each one is posted right away.
+// Past that, they are collected and posted together once per window, editing the burst's message
+// in place for as long as the list fits in it.
+class MemberAnnouncer final {
+public:
+  MemberAnnouncer() = delete;
+  ~MemberAnnouncer();
+
+  MemberAnnouncer(std::shared_ptr<Rest> rest);
+
+  void AnnounceJoin(dpp::snowflake guild_id, dpp::snowflake user_id);
+  void AnnounceLeave(dpp::snowflake guild_id, dpp::snowflake user_id);
+
+  // Posts the lines the bursts still hold and stops. Lines not posted by the deadline are dropped,
+  // along with a REST call still in flight at the deadline. Stopping again does nothing.
+  void Stop(std::chrono::steady_clock::time_point deadline);
+
+private:
+  struct GuildBurst {
+    std::deque<std::chrono::steady_clock::time_point> recent_announcements;
+    std::vector<std::string> pending_lines;
+    std::chrono::steady_clock::time_point flush_due;
+    dpp::message burst_message;
+    uint64_t burst_generation{};
+  };
+
+  void Announce(dpp::snowflake guild_id, std::string line);
+  void Flush(dpp::snowflake guild_id, std::vector<std::string> const& lines, dpp::message& burst_message);
+  // Waits for a REST call until it completes or the stop deadline passes, whichever comes first.
+  std::optional<dpp::confirmation_callback_t> Await(std::function<void(dpp::command_completion_event_t)> const& call) const;
+  void Run();
+
+private:
+  Logger const logger_ = LoggerFactory::Get().Create("Member Announcer");
+
+  std::shared_ptr<Rest> const rest_;
+
+  std::size_t const burst_threshold_;
+  std::chrono::seconds const burst_window_;
+
+  std::mutex guild_bursts_mutex_;
+  std::condition_variable guild_bursts_condition_;
+  std::map<dpp::snowflake, GuildBurst> guild_bursts_;
+  bool stopping_{};
+  std::atomic<std::chrono::steady_clock::time_point> stop_deadline_ = std::chrono::steady_clock::time_point::max();
+
+  std::thread thread_;
+};
\ No newline at end of file
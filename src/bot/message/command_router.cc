@@ -0,0 +1,78 @@
+#include "command_router.h"
+
+#include <algorithm>
+#include <utility>
+
+#include "settings/settings.h"
+
+void CommandRouter::RegisterChannel(dpp::snowflake const channel_id, Handler handler) {
+  channel_routes_[channel_id] = std::move(handler);
+}
+
+void CommandRouter::RegisterSlashCommand(std::string const& name, std::string const& description, std::vector<dpp::command_option> const& options, Permission const permission, SlashCommandHandler handler) {
+  slash_commands_[name] = SlashCommandRegistration{.description = description, .options = options, .permission = permission, .handler = std::move(handler)};
+}
+
+std::vector<dpp::slashcommand> CommandRouter::GetSlashCommands(dpp::snowflake const application_id) const {
+  std::vector<dpp::slashcommand> slash_commands;
+  std::ranges::for_each(slash_commands_, [&slash_commands, &application_id](auto const& name_and_registration) {
+    auto slash_command = dpp::slashcommand(name_and_registration.first, name_and_registration.second.description, application_id);
+    std::ranges::for_each(name_and_registration.second.options, [&slash_command](auto const& option) { slash_command.add_option(option); });
+    slash_commands.push_back(std::move(slash_command));
+  });
+
+  return slash_commands;
+}
+
+bool CommandRouter::Matches(dpp::message const& message) const noexcept {
+  if (message.author.is_bot()) {
+    return false;
+  }
+
+  return channel_routes_.contains(message.channel_id);
+}
+
+dpp::task<bool> CommandRouter::Route(MessageEvent const& message) noexcept {
+  auto const it_handler = channel_routes_.find(message.channel_id);
+  if (channel_routes_.cend() == it_handler) {
+    co_return false;
+  }
+
+  co_await it_handler->second(message);
+  co_return true;
+}
+
+bool CommandRouter::IsPermitted(dpp::slashcommand_t const& slash_command) const noexcept {
+  auto const it_slash_command = slash_commands_.find(slash_command.command.get_command_name());
+  if (slash_commands_.cend() == it_slash_command) {
+    return false;
+  }
+
+  if (Permission::kEveryone == it_slash_command->second.permission) {
+    return true;
+  }
+
+  auto const* guild = Settings::Get().FindGuild(slash_command.command.guild_id);
+  if (nullptr == guild) {
+    return false;
+  }
+
+  auto const& roles = slash_command.command.member.get_roles();
+  return std::ranges::any_of(roles, [guild](auto const& role) { return guild->GetRoleId(Settings::Roles::kModerator) == role; });
+}
+
+dpp::task<void> CommandRouter::Route(dpp::slashcommand_t const& slash_command) noexcept {
+  auto const command_name = slash_command.command.get_command_name();
+  auto const it_slash_command = slash_commands_.find(command_name);
+  if (slash_commands_.cend() == it_slash_command) {
+    co_return;
+  }
+
+  auto const response = co_await it_slash_command->second.handler(slash_command);
+  // Captures a copy of the logger, since the response can complete after the router is gone.
+  slash_command.edit_original_response(response, [logger = logger_, command_name](dpp::confirmation_callback_t const& confirmation) {
+    if (confirmation.is_error()) {
+      logger.Error("Failed to respond to slash command '{}'. Error '{}'", command_name, confirmation.get_error().human_readable);
+    }
+  });
+}
\ No newline at end of file
@@ -0,0 +1,57 @@
+#pragma once
+
+#include <functional>
+#include <map>
+#include <string>
+#include <unordered_map>
+#include <vector>
+
+#include <dpp/dpp.h>
+
+#include "logger/logger_factory.h"
+#include "message_event.h"
+
+// Dispatches messages to handlers registered by channel, and slash commands by name. Messages are
+// matched against the channel table before anything else is done, so messages no handler is
+// interested in cost nothing beyond the lookup. Slash commands carry the invoking member, so their
+// permissions are checked without any REST call at all. Handlers are coroutines; routing awaits
+// them without holding a thread while their REST calls run.
+class CommandRouter final {
+public:
+  enum class Permission {
+    kEveryone,
+    kModerator
+  };
+
+  using Handler = std::function<dpp::task<void>(MessageEvent const&)>;
+  using SlashCommandHandler = std::function<dpp::task<dpp::message>(dpp::slashcommand_t const&)>;
+
+  CommandRouter() = default;
+  ~CommandRouter() = default;
+
+  void RegisterChannel(dpp::snowflake channel_id, Handler handler);
+  void RegisterSlashCommand(std::string const& name, std::string const& description, std::vector<dpp::command_option> const& options, Permission permission, SlashCommandHandler handler);
+
+  std::vector<dpp::slashcommand> GetSlashCommands(dpp::snowflake application_id) const;
+
+  // Matching reads the DPP message in place, so only messages some handler wants are extracted.
+  bool Matches(dpp::message const& message) const noexcept;
+  dpp::task<bool> Route(MessageEvent const& message) noexcept;
+
+  bool IsPermitted(dpp::slashcommand_t const& slash_command) const noexcept;
+  dpp::task<void> Route(dpp::slashcommand_t const& slash_command) noexcept;
+
+private:
+  struct SlashCommandRegistration {
+    std::string description;
+    std::vector<dpp::command_option> options;
+    Permission permission{};
+    SlashCommandHandler handler;
+  };
+
+private:
+  Logger const logger_ = LoggerFactory::Get().Create("Command Router");
+
+  std::unordered_map<dpp::snowflake, Handler> channel_routes_;
+  std::map<std::string, SlashCommandRegistration> slash_commands_;
+};
\ No newline at end of file
@@ -0,0 +1,117 @@
+#include "deletion_scheduler.h"
+
+#include <filesystem>
+#include <fstream>
+#include <utility>
+
+#include <nlohmann/json.hpp>
+
+DeletionScheduler::DeletionScheduler(std::shared_ptr<Rest> rest) :
+  rest_(std::move(rest)),
+  thread_(&DeletionScheduler::Run, this) {
+
+}
+
+DeletionScheduler::~DeletionScheduler() {
+  Stop();
+}
+
+void DeletionScheduler::Schedule(dpp::snowflake const message_id, dpp::snowflake const channel_id, std::chrono::system_clock::time_point const due) {
+  {
+    std::scoped_lock<std::mutex> const mutex_lock(pending_deletions_mutex_);
+    pending_deletions_.push(PendingDeletion{.message_id = message_id, .channel_id = channel_id, .due = due});
+  }
+  pending_deletions_condition_.notify_all();
+}
+
+std::vector<DeletionScheduler::PendingDeletion> DeletionScheduler::Stop() {
+  {
+    std::scoped_lock<std::mutex> const mutex_lock(pending_deletions_mutex_);
+    stopping_ = true;
+  }
+  pending_deletions_condition_.notify_all();
+  if (thread_.joinable()) {
+    thread_.join();
+  }
+
+  std::vector<PendingDeletion> pending_deletions;
+  std::scoped_lock<std::mutex> const mutex_lock(pending_deletions_mutex_);
+  while (!pending_deletions_.empty()) {
+    pending_deletions.push_back(pending_deletions_.top());
+    pending_deletions_.pop();
+  }
+
+  return pending_deletions;
+}
+
+std::vector<DeletionScheduler::PendingDeletion> DeletionScheduler::Load(std::string const& path) const noexcept {
+  std::vector<PendingDeletion> pending_deletions;
+  if (!std::filesystem::exists(path)) {
+    return pending_deletions;
+  }
+
+  try {
+    std::ifstream state_file(path);
+    auto const state_json = nlohmann::json::parse(state_file);
+    for (auto const& deletion_json : state_json.value("pending_deletions", nlohmann::json::array())) {
+      pending_deletions.push_back(PendingDeletion{
+        .message_id = dpp::snowflake(deletion_json["message_id"].get<uint64_t>()),
+        .channel_id = dpp::snowflake(deletion_json["channel_id"].get<uint64_t>()),
+        .due = std::chrono::system_clock::time_point(std::chrono::seconds(deletion_json["due"].get<long long>()))
+      });
+    }
+  } catch (nlohmann::json::exception const& json_exception) {
+    logger_.Error("Failed to load pending deletions from '{}'. Exception: '{}'", path, json_exception.what());
+  }
+
+  std::error_code remove_error;
+  std::filesystem::remove(path, remove_error);
+
+  return pending_deletions;
+}
+
+void DeletionScheduler::Save(std::string const& path, std::vector<PendingDeletion> const& pending_deletions) const noexcept {
+  auto deletions_json = nlohmann::json::array();
+  for (auto const& pending_deletion : pending_deletions) {
+    deletions_json.push_back({
+      {"message_id", static_cast<uint64_t>(pending_deletion.message_id)},
+      {"channel_id", static_cast<uint64_t>(pending_deletion.channel_id)},
+      {"due", std::chrono::duration_cast<std::chrono::seconds>(pending_deletion.due.time_since_epoch()).count()}
+    });
+  }
+
+  std::ofstream state_file(path, std::ios::trunc);
+  state_file << nlohmann::json{{"pending_deletions", deletions_json}}.dump(2);
+  if (!state_file) {
+    logger_.Error("Failed to save {} pending deletions to '{}'", pending_deletions.size(), path);
+  }
+}
+
+void DeletionScheduler::Run() {
+  std::unique_lock<std::mutex> mutex_lock(pending_deletions_mutex_);
+  while (!stopping_) {
+    if (pending_deletions_.empty()) {
+      pending_deletions_condition_.wait(mutex_lock);
+      continue;
+    }
+
+    auto const pending_deletion = pending_deletions_.top();
+    if (std::chrono::system_clock::now() < pending_deletion.due) {
+      pending_deletions_condition_.wait_until(mutex_lock, pending_deletion.due);
+      continue;
+    }
+
+    pending_deletions_.pop();
+
+    mutex_lock.unlock();
+    rest_->MessageDelete(pending_deletion.message_id, pending_deletion.channel_id, [logger = logger_, pending_deletion](dpp::confirmation_callback_t const& confirmation) {
+      if (confirmation.is_error()) {
+        logger.Error("Failed to delete message '{}' in channel '{}'. Error '{}'", pending_deletion.message_id.str(), pending_deletion.channel_id.str(), confirmation.get_error().human_readable);
+        return;
+      }
+
+      logger.Info("Deleted message with id '{}'", pending_deletion.message_id.str());
+    });
+    mutex_lock.lock();
+  }
+}
\ No newline at end of file
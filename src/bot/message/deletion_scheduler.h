@@ -0,0 +1,57 @@
+#pragma once
+
+#include <chrono>
+#include <condition_variable>
+#include <memory>
+#include <mutex>
+#include <queue>
+#include <string>
+#include <thread>
+#include <vector>
+
+#include <dpp/dpp.h>
+
+#include "logger/logger_factory.h"
+#include "rest/rest.h"
+
+// Deletes messages once their lifetime is over, from a single thread instead of one sleeping
+// thread per message. Deletions still pending at shutdown are handed back so they can be saved
+// and scheduled again on the next start.
+class DeletionScheduler final {
+public:
+  struct PendingDeletion {
+    dpp::snowflake message_id;
+    dpp::snowflake channel_id;
+    std::chrono::system_clock::time_point due;
+
+    bool operator>(PendingDeletion const& other) const noexcept {
+      return due > other.due;
+    }
+  };
+
+  DeletionScheduler() = delete;
+  ~DeletionScheduler();
+
+  DeletionScheduler(std::shared_ptr<Rest> rest);
+
+  void Schedule(dpp::snowflake message_id, dpp::snowflake channel_id, std::chrono::system_clock::time_point due);
+  std::vector<PendingDeletion> Stop();
+
+  std::vector<PendingDeletion> Load(std::string const& path) const noexcept;
+  void Save(std::string const& path, std::vector<PendingDeletion> const& pending_deletions) const noexcept;
+
+private:
+  void Run();
+
+private:
+  Logger const logger_ = LoggerFactory::Get().Create("Deletion Scheduler");
+
+  std::shared_ptr<Rest> const rest_;
+
+  std::mutex pending_deletions_mutex_;
+  std::condition_variable pending_deletions_condition_;
+  std::priority_queue<PendingDeletion, std::vector<PendingDeletion>, std::greater<>> pending_deletions_;
+  bool stopping_{};
+
+  std::thread thread_;
+};
\ No newline at end of file
@@ -0,0 +1,73 @@
+#include "direct_messenger.h"
+
+#include <algorithm>
+
+DirectMessenger::DirectMessenger(std::shared_ptr<Rest> rest, std::shared_ptr<DmChannelCache> dm_channel_cache) noexcept :
+  rest_(std::move(rest)),
+  dm_channel_cache_(std::move(dm_channel_cache)) {
+
+}
+
+void DirectMessenger::Send(dpp::snowflake const user_id, dpp::message const& message, dpp::command_completion_event_t callback) {
+  auto const channel_id = dm_channel_cache_->Find(user_id);
+  if (!channel_id) {
+    Open(user_id, message, std::move(callback));
+    return;
+  }
+
+  Post(*channel_id, message, [this, user_id, message, callback = std::move(callback)](dpp::confirmation_callback_t const& confirmation) mutable {
+    uint16_t constexpr kNotFound = 404;
+    if (confirmation.is_error() && (kNotFound == confirmation.http_info.status)) {
+      logger_.Warn("Cached DM channel of user '{}' is gone, opening it again", user_id.str());
+      dm_channel_cache_->Erase(user_id);
+      Open(user_id, message, std::move(callback));
+      return;
+    }
+
+    if (callback) {
+      callback(confirmation);
+    }
+  });
+}
+
+void DirectMessenger::Post(dpp::snowflake const channel_id, dpp::message const& message, dpp::command_completion_event_t callback) {
+  auto direct_message = message;
+  direct_message.channel_id = channel_id;
+  rest_->MessageCreate(direct_message, std::move(callback));
+}
+
+void DirectMessenger::Open(dpp::snowflake const user_id, dpp::message const& message, dpp::command_completion_event_t callback) {
+  {
+    std::scoped_lock<std::mutex> const mutex_lock(pending_opens_mutex_);
+    auto& pending_messages = pending_opens_[user_id];
+    pending_messages.emplace_back(message, std::move(callback));
+    if (1 != pending_messages.size()) {
+      return;
+    }
+  }
+
+  rest_->CreateDmChannel(user_id, [this, user_id](dpp::confirmation_callback_t const& confirmation) {
+    std::vector<std::pair<dpp::message, dpp::command_completion_event_t>> pending_messages;
+    {
+      std::scoped_lock<std::mutex> const mutex_lock(pending_opens_mutex_);
+      auto node = pending_opens_.extract(user_id);
+      pending_messages = std::move(node.mapped());
+    }
+
+    if (confirmation.is_error()) {
+      logger_.Error("Failed to open DM channel of user '{}'. Error: '{}'", user_id.str(), confirmation.get_error().human_readable);
+      std::ranges::for_each(pending_messages, [&confirmation](auto const& pending_message) {
+        if (pending_message.second) {
+          pending_message.second(confirmation);
+        }
+      });
+      return;
+    }
+
+    auto const channel_id = confirmation.get<dpp::channel>().id;
+    dm_channel_cache_->Insert(user_id, channel_id);
+    std::ranges::for_each(pending_messages, [this, channel_id](auto& pending_message) {
+      Post(channel_id, pending_message.first, std::move(pending_message.second));
+    });
+  });
+}
\ No newline at end of file
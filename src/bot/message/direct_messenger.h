@@ -0,0 +1,43 @@
+#pragma once
+
+#include <map>
+#include <memory>
+#include <mutex>
+#include <utility>
+#include <vector>
+
+#include <dpp/dpp.h>
+
+#include "cache/dm_channel_cache.h"
+#include "logger/logger_factory.h"
+#include "rest/rest.h"
+
+// Sends direct messages through the DM channel cache, so a DM to a user seen before is a single
+// message post. A user's channel is opened once even when several DMs to them miss at the same
+// time, and a cached channel Discord no longer knows is dropped and opened again.
+class DirectMessenger final {
+public:
+  DirectMessenger() = delete;
+  ~DirectMessenger() = default;
+
+  DirectMessenger(std::shared_ptr<Rest> rest, std::shared_ptr<DmChannelCache> dm_channel_cache) noexcept;
+
+  void Send(dpp::snowflake user_id, dpp::message const& message, dpp::command_completion_event_t callback = {});
+
+  dpp::async<dpp::confirmation_callback_t> CoSend(dpp::snowflake const user_id, dpp::message const& message) {
+    return dpp::async<dpp::confirmation_callback_t>{this, &DirectMessenger::Send, user_id, message};
+  }
+
+private:
+  void Post(dpp::snowflake channel_id, dpp::message const& message, dpp::command_completion_event_t callback);
+  void Open(dpp::snowflake user_id, dpp::message const& message, dpp::command_completion_event_t callback);
+
+private:
+  Logger const logger_ = LoggerFactory::Get().Create("Direct Messenger");
+
+  std::shared_ptr<Rest> const rest_;
+  std::shared_ptr<DmChannelCache> const dm_channel_cache_;
+
+  std::mutex pending_opens_mutex_;
+  std::map<dpp::snowflake, std::vector<std::pair<dpp::message, dpp::command_completion_event_t>>> pending_opens_;
+};
\ No newline at end of file
@@ -0,0 +1,24 @@
+#include "message_event.h"
+
+#include <algorithm>
+#include <numeric>
+
+MessageEvent MessageEvent::FromMessage(dpp::message const& message) {
+  MessageEvent message_event;
+  message_event.id = message.id;
+  message_event.channel_id = message.channel_id;
+  message_event.guild_id = message.guild_id;
+  message_event.author_id = message.author.id;
+  message_event.content = message.content;
+  std::ranges::for_each(message.attachments, [&message_event](auto const& attachment) {
+    if (attachment.content_type.starts_with("video/")) {
+      message_event.video_urls.push_back(attachment.url);
+    }
+  });
+  return message_event;
+}
+
+std::size_t MessageEvent::GetBytes() const noexcept {
+  return std::accumulate(video_urls.cbegin(), video_urls.cend(), sizeof(MessageEvent) + content.capacity() + (video_urls.capacity() * sizeof(std::string)),
+                         [](std::size_t const bytes, auto const& video_url) { return bytes + video_url.capacity(); });
+}
\ No newline at end of file
@@ -0,0 +1,32 @@
+#pragma once
+
+#include <cstddef>
+#include <string>
+#include <vector>
+
+#include <dpp/dpp.h>
+
+// The fields of a created message that its handlers read, taken out of the DPP event on the gateway
+// thread. A full dpp::message drags the author, member, embeds and every attachment along with it;
+// this keeps the content and the video attachment URLs, and is only ever moved on to the workers.
+struct MessageEvent {
+  dpp::snowflake id;
+  dpp::snowflake channel_id;
+  dpp::snowflake guild_id;
+  dpp::snowflake author_id;
+  std::string content;
+  std::vector<std::string> video_urls;
+
+  MessageEvent() = default;
+  ~MessageEvent() = default;
+
+  MessageEvent(MessageEvent const&) = delete;
+  MessageEvent& operator=(MessageEvent const&) = delete;
+  MessageEvent(MessageEvent&&) noexcept = default;
+  MessageEvent& operator=(MessageEvent&&) noexcept = default;
+
+  static MessageEvent FromMessage(dpp::message const& message);
+
+  // Bytes held by the event, inline and on the heap.
+  std::size_t GetBytes() const noexcept;
+};
\ No newline at end of file
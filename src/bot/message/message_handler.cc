@@ -3,123 +3,266 @@
 #include <algorithm>
 #include <print>
 #include <ranges>
+#include <set>
 #include <utility>
 
+#include "clip/clip_url.h"
 #include "settings/settings.h"
 
 namespace{
-  std::string RemoveCommandHeader(std::string const& content) {
-    auto constexpr kCommandLength = 3ULL;
-    return content.substr(kCommandLength, content.size() - kCommandLength);
+  auto constexpr kTextOption = "texto";
+  auto constexpr kCategoryOption = "categoria";
+
+  std::string GetStringParameter(dpp::slashcommand_t const& slash_command, std::string const& option) {
+    auto const text = slash_command.get_parameter(option);
+    return std::holds_alternative<std::string>(text) ? std::get<std::string>(text) : std::string();
   }
 }
 
-MessageHandler::MessageHandler(std::shared_ptr<dpp::cluster> bot) noexcept :
-  bot_(std::move(bot)) {
-  nomination_content_header_ = std::string("Você gostaria de indicar esse vídeo para o Super Mario 64 Brasil Awards? Se sim, reaja de acordo com a categoria desejada (apenas uma reação por vídeo):\n");
+MessageHandler::MessageHandler(std::shared_ptr<Rest> rest, std::shared_ptr<DeletionScheduler> deletion_scheduler, std::shared_ptr<ClipIndex> clip_index,
+                               std::shared_ptr<AwardsTally> awards_tally, std::shared_ptr<DirectMessenger> direct_messenger,
+                               std::shared_ptr<UserThrottle> user_throttle) noexcept :
+  rest_(std::move(rest)),
+  deletion_scheduler_(std::move(deletion_scheduler)),
+  clip_index_(std::move(clip_index)),
+  awards_tally_(std::move(awards_tally)),
+  direct_messenger_(std::move(direct_messenger)),
+  user_throttle_(std::move(user_throttle)) {
+  std::ranges::for_each(Settings::Get().GetGuilds(), [this](auto const& guild_id_and_guild) {
+    auto const& guild = guild_id_and_guild.second;
+
+    auto& nomination_content_header = nomination_content_headers_[guild.GetGuildId()];
+    nomination_content_header = std::string("Você gostaria de indicar esse vídeo para o Super Mario 64 Brasil Awards? Se sim, reaja de acordo com a categoria desejada (apenas uma reação por vídeo):\n");
+    std::ranges::for_each(guild.GetAwardsReactionsAndCategories(), [&nomination_content_header](auto const& reaction_and_category) {
+      nomination_content_header.append(std::format("{} - {}\n", reaction_and_category.first, reaction_and_category.second));
+    });
+
+    command_router_.RegisterChannel(guild.GetChannelId(Settings::Channels::kStreams), [this](auto const& message) -> dpp::task<void> {
+      ProcessStreamingMessage(message.channel_id, message.author_id, message.id, message.content);
+      co_return;
+    });
+    command_router_.RegisterChannel(guild.GetChannelId(Settings::Channels::kClips), [this](auto const& message) -> dpp::task<void> {
+      co_await ProcessAwardsMessage(message.guild_id, message.author_id, message.id, message.content, message.video_urls);
+    });
+  });
+
+  auto const text_option = dpp::command_option(dpp::co_string, kTextOption, "Texto a ser enviado", true);
+  command_router_.RegisterSlashCommand("anuncio", "Envia um anúncio para @everyone neste canal", {text_option}, CommandRouter::Permission::kModerator, [this](auto const& slash_command) -> dpp::task<dpp::message> {
+    auto const sent = co_await ProcessAnnouncementMessage(slash_command.command.channel_id, ::GetStringParameter(slash_command, kTextOption));
+    co_return dpp::message(sent ? "Anúncio enviado." : "Não foi possível enviar o anúncio.");
+  });
+  command_router_.RegisterSlashCommand("mensagem", "Envia uma mensagem do bot neste canal", {text_option}, CommandRouter::Permission::kModerator, [this](auto const& slash_command) -> dpp::task<dpp::message> {
+    auto const sent = co_await ProcessGeneralMessage(slash_command.command.channel_id, ::GetStringParameter(slash_command, kTextOption));
+    co_return dpp::message(sent ? "Mensagem enviada." : "Não foi possível enviar a mensagem.");
+  });
+
+  auto constexpr kMaxOptionChoices = 25;
+  auto category_option = dpp::command_option(dpp::co_string, kCategoryOption, "Categoria das indicações (todas se omitida)", false);
+  std::set<std::string> categories;
+  std::ranges::for_each(Settings::Get().GetGuilds(), [&categories](auto const& guild_id_and_guild) {
+    std::ranges::for_each(guild_id_and_guild.second.GetAwardsReactionsAndCategories(), [&categories](auto const& reaction_and_category) { categories.insert(reaction_and_category.second); });
+  });
+  std::ranges::for_each(categories | std::views::take(kMaxOptionChoices), [&category_option](auto const& category) { category_option.add_choice(dpp::command_option_choice(category, category)); });
 
-  auto const awards_reactions_and_categories = Settings::Get().GetAwardsReactionsAndCategories();
-  std::ranges::for_each(awards_reactions_and_categories, [this](auto const& reaction_and_category) {
-    nomination_content_header_.append(std::format("{} - {}\n", reaction_and_category.first, reaction_and_category.second));
+  command_router_.RegisterSlashCommand("indicacoes", "Mostra os clipes indicados mais recentemente ao Awards", {category_option}, CommandRouter::Permission::kModerator, [this](auto const& slash_command) -> dpp::task<dpp::message> {
+    co_return BuildNominationsMessage(slash_command.command.guild_id, ::GetStringParameter(slash_command, kCategoryOption));
+  });
+  command_router_.RegisterSlashCommand("exportar", "Exporta todas as indicações do Awards", {}, CommandRouter::Permission::kModerator, [this](auto const& slash_command) -> dpp::task<dpp::message> {
+    co_return BuildTallyExportMessage(slash_command.command.guild_id);
   });
 }
 
-void MessageHandler::Process(dpp::message const& message) noexcept {
-  auto const member_confirmation = bot_->co_guild_get_member(message.guild_id, message.author.id).sync_wait();
-  if (member_confirmation.is_error()) {
-    logger_.Error("Failed to get member while processing message create. Error '{}'", member_confirmation.get_error().human_readable);
-    return;
-  }
+std::vector<dpp::slashcommand> MessageHandler::GetSlashCommands(dpp::snowflake const application_id) const {
+  return command_router_.GetSlashCommands(application_id);
+}
 
-  auto const member = member_confirmation.get<dpp::guild_member>();
-  auto const from_moderator = std::ranges::any_of(member.get_roles(), [this](auto const& role) { return Settings::Get().GetRoleId(Settings::Roles::kModerator) == role; });
-  auto const from_bot = message.author.is_bot();
+bool MessageHandler::IsRoutable(dpp::message const& message) const noexcept {
+  return command_router_.Matches(message);
+}
 
-  auto const is_announcement_message = 0 == message.content.rfind("!a ", 0);
-  if (is_announcement_message && from_moderator && !from_bot) {
-    ProcessAnnouncementMessage(message.channel_id, message.content);
-    return;
-  }
+bool MessageHandler::IsPermitted(dpp::slashcommand_t const& slash_command) const noexcept {
+  return command_router_.IsPermitted(slash_command);
+}
 
-  auto const is_general_message = 0 == message.content.rfind("!m ", 0);
-  if (is_general_message && from_moderator && !from_bot) {
-    ProcessGeneralMessage(message.channel_id, message.content);
-    return;
-  }
+dpp::task<void> MessageHandler::Process(MessageEvent const& message) noexcept {
+  co_await command_router_.Route(message);
+}
 
-  auto const is_streaming_message = Settings::Get().GetChannelId(Settings::Channels::kStreams) == message.channel_id;
-  if (is_streaming_message && !from_bot) {
-    ProcessStreamingMessage(message.author.id, message.id, message.content);
-    return;
-  }
-  
-  auto const is_clip_message = Settings::Get().GetChannelId(Settings::Channels::kClips) == message.channel_id;
-  if (is_clip_message && !from_bot) {
-    ProcessAwardsMessage(message.author.id, message.id, message.content, message.attachments);
-    return;
-  }
+dpp::task<void> MessageHandler::Process(dpp::slashcommand_t const& slash_command) noexcept {
+  co_await command_router_.Route(slash_command);
 }
 
-void MessageHandler::ProcessAnnouncementMessage(dpp::snowflake const channel_id, std::string const& content) const noexcept {
-  auto const announcement = std::format("@everyone {}", ::RemoveCommandHeader(content));
-  logger_.Info("Received announcement message '{}'", announcement);
+dpp::task<bool> MessageHandler::ProcessAnnouncementMessage(dpp::snowflake const channel_id, std::string const& text) const noexcept {
+  // The content is formatted straight into the message, so the text is allocated once.
+  dpp::message announcement_message(channel_id, std::string());
+  announcement_message.content = std::format("@everyone {}", text);
+  announcement_message.set_allowed_mentions(false, false, true);
+  logger_.Info("Received announcement message '{}'", announcement_message.content);
+
+  auto const announcement_confirmation = co_await rest_->CoMessageCreate(announcement_message);
+  if (announcement_confirmation.is_error()) {
+    logger_.Error("Failed to send announcement message to channel '{}'. Error '{}'", channel_id.str(), announcement_confirmation.get_error().human_readable);
+    co_return false;
+  }
 
-  auto const announcement_message = dpp::message(channel_id, announcement).set_allowed_mentions(false, false, true);
-  bot_->message_create(announcement_message);
+  co_return true;
 }
 
-void MessageHandler::ProcessGeneralMessage(dpp::snowflake const channel_id, std::string const& content) const noexcept {
-  auto const general_announcement = ::RemoveCommandHeader(content);
-  logger_.Info("Received general message '{}'", general_announcement);
+dpp::task<bool> MessageHandler::ProcessGeneralMessage(dpp::snowflake const channel_id, std::string const& text) const noexcept {
+  logger_.Info("Received general message '{}'", text);
+
+  auto const general_confirmation = co_await rest_->CoMessageCreate(dpp::message(channel_id, text));
+  if (general_confirmation.is_error()) {
+    logger_.Error("Failed to send general message to channel '{}'. Error '{}'", channel_id.str(), general_confirmation.get_error().human_readable);
+    co_return false;
+  }
 
-  bot_->message_create(dpp::message(channel_id, general_announcement));
+  co_return true;
 }
 
-void MessageHandler::ProcessStreamingMessage(dpp::snowflake const user_id, dpp::snowflake const message_id, std::string const& content) noexcept {
+void MessageHandler::ProcessStreamingMessage(dpp::snowflake const channel_id, dpp::snowflake const user_id, dpp::snowflake const message_id, std::string const& content) noexcept {
   logger_.Info("Received streaming message with id '{}'", message_id.str());
 
   if (std::regex_search(content, url_regex_)) {
-    auto constexpr kStreamingMessageDeleteDelay = std::chrono::hours(6);
-    std::this_thread::sleep_for(kStreamingMessageDeleteDelay);
+    deletion_scheduler_->Schedule(message_id, channel_id, std::chrono::system_clock::now() + Settings::Get().GetStreamingMessageLifetime());
+    return;
   }
-  else {
+
+  // The message is deleted either way; only the explanation is throttled, as every DM to a user
+  // without an open channel costs two calls against the global limit.
+  if (user_throttle_->TryAcquire(UserThrottle::Action::kStreamingMessage, user_id)) {
     auto const invalid_streaming_message = "Por favor, poste apenas mensagens com uma URL para uma stream de Super Mario 64 no canal **#streams**!";
-    bot_->direct_message_create(user_id, dpp::message(invalid_streaming_message));
+    direct_messenger_->Send(user_id, dpp::message(invalid_streaming_message));
+  } else {
+    logger_.Info("Throttled invalid streaming message DM to user '{}'", user_id.str());
   }
-
-  bot_->message_delete(message_id, Settings::Get().GetChannelId(Settings::Channels::kStreams));
+  rest_->MessageDelete(message_id, channel_id);
 
   logger_.Info("Deleted streaming message with id '{}'", message_id.str());
 }
 
-void MessageHandler::ProcessAwardsMessage(dpp::snowflake const user_id, dpp::snowflake const message_id, std::string const& content, std::vector<dpp::attachment> const& attachments) noexcept {    
-  for (auto it = std::sregex_iterator(content.begin(), content.end(), url_regex_); it != std::sregex_iterator(); ++it) {
-    SendNominationMessage(user_id, it->str());
+dpp::task<void> MessageHandler::ProcessAwardsMessage(dpp::snowflake const guild_id, dpp::snowflake const user_id, dpp::snowflake const message_id, std::string const& content, std::vector<std::string> const& video_urls) noexcept {
+  std::vector<std::string_view> clip_urls;
+  std::smatch url_match;
+  for (auto search_start = content.cbegin(); std::regex_search(search_start, content.cend(), url_match, url_regex_); search_start = url_match.suffix().first) {
+    clip_urls.emplace_back(url_match[0].first, url_match[0].second);
   }
 
-  std::ranges::for_each(attachments, [this, &user_id](auto const& attachment) {
-    if (attachment.content_type.rfind("video/", 0) == 0) {
-      SendNominationMessage(user_id, attachment.url);
+  clip_urls.insert(clip_urls.end(), video_urls.cbegin(), video_urls.cend());
+
+  std::erase_if(clip_urls, [this, &guild_id, &user_id](auto const clip_url) {
+    auto const canonical_url = ClipUrl::Canonicalize(clip_url);
+    if (canonical_url.empty()) {
+      logger_.Info("Skipping clip '{}' without a video id", clip_url);
+      return true;
+    }
+
+    // Each nominated clip costs a DM and a reaction per category, so the user's budget is checked
+    // before the clip is taken.
+    if (!user_throttle_->TryAcquire(UserThrottle::Action::kClipLink, user_id)) {
+      logger_.Info("Throttled clip '{}' from user '{}'", clip_url, user_id.str());
+      return true;
+    }
+
+    if (clip_index_->Insert(guild_id, canonical_url)) {
+      return false;
     }
+
+    logger_.Info("Skipping clip '{}' that was already nominated", clip_url);
+    return true;
   });
+
+  // Each clip gets its own nomination message, so they are all sent at once and awaited together.
+  std::vector<dpp::task<void>> nominations;
+  std::ranges::for_each(clip_urls, [this, &nominations, &guild_id, &user_id](auto const clip_url) { nominations.push_back(SendNominationMessage(guild_id, user_id, clip_url)); });
+  for (auto& nomination : nominations) {
+    co_await nomination;
+  }
 }
 
-void MessageHandler::SendNominationMessage(dpp::snowflake const user_id, std::string const& clip_url) noexcept {
-  auto nomination_content = nomination_content_header_;
-  nomination_content.append(clip_url);
+dpp::snowflake MessageHandler::FindNominationGuildId(dpp::snowflake const nomination_message_id) const noexcept {
+  std::scoped_lock<std::mutex> const mutex_lock(nomination_messages_guilds_ids_mutex_);
+
+  auto const it_guild_id = nomination_messages_guilds_ids_.find(nomination_message_id);
+  return (nomination_messages_guilds_ids_.cend() != it_guild_id) ? it_guild_id->second : dpp::snowflake{};
+}
 
-  auto const sent_message_confirmation = bot_->co_direct_message_create(user_id, dpp::message(nomination_content)).sync_wait();
+dpp::task<void> MessageHandler::SendNominationMessage(dpp::snowflake const guild_id, dpp::snowflake const user_id, std::string_view const clip_url) noexcept {
+  auto const* guild = Settings::Get().FindGuild(guild_id);
+  if (nullptr == guild) {
+    co_return;
+  }
+
+  dpp::message nomination_message;
+  nomination_message.content.reserve(nomination_content_headers_.at(guild_id).size() + clip_url.size());
+  nomination_message.content.append(nomination_content_headers_.at(guild_id)).append(clip_url);
+
+  auto const sent_message_confirmation = co_await direct_messenger_->CoSend(user_id, nomination_message);
   if (sent_message_confirmation.is_error()) {
-    logger_.Error("Failed to send nomination message '{}' to user '{}'. Error: '{}'", nomination_content, user_id.str(), sent_message_confirmation.get_error().human_readable);
-    return;
+    logger_.Error("Failed to send nomination message '{}' to user '{}'. Error: '{}'", nomination_message.content, user_id.str(), sent_message_confirmation.get_error().human_readable);
+    // The clip was recorded before the DM went out, so it is forgotten again to let a repost retry.
+    clip_index_->Erase(guild_id, ClipUrl::Canonicalize(clip_url));
+    co_return;
   }
-  
+
   auto const sent_message = sent_message_confirmation.get<dpp::message>();
-  auto const awards_reactions_and_categories = Settings::Get().GetAwardsReactionsAndCategories();
-  std::ranges::for_each(awards_reactions_and_categories, [this, &sent_message, &user_id](auto const& reaction_and_category) {
-    auto const add_reaction_confirmation = bot_->co_message_add_reaction(sent_message, reaction_and_category.first).sync_wait();
-    if (add_reaction_confirmation.is_error()) {
-      logger_.Error("Failed to add awards reaction '{}' in nomination message '{}' to user '{}. Error: '{}'", reaction_and_category.first, sent_message.id.str(), user_id.str(), add_reaction_confirmation.get_error().human_readable);
+  {
+    auto constexpr kMaxTrackedNominations = 4096ULL;
+
+    std::scoped_lock<std::mutex> const mutex_lock(nomination_messages_guilds_ids_mutex_);
+    nomination_messages_guilds_ids_[sent_message.id] = guild_id;
+    if (nomination_messages_guilds_ids_.size() > kMaxTrackedNominations) {
+      nomination_messages_guilds_ids_.erase(nomination_messages_guilds_ids_.begin());
     }
+  }
+
+  // All reactions are requested before any is awaited. They share a rate limit bucket, which DPP
+  // serves from a single request thread in submission order, so they still appear in category order.
+  auto const& reactions_and_categories = guild->GetAwardsReactionsAndCategories();
+  std::vector<dpp::async<dpp::confirmation_callback_t>> add_reactions;
+  add_reactions.reserve(reactions_and_categories.size());
+  std::ranges::for_each(reactions_and_categories, [this, &add_reactions, &sent_message](auto const& reaction_and_category) {
+    add_reactions.push_back(rest_->CoMessageAddReaction(sent_message.id, sent_message.channel_id, reaction_and_category.first));
   });
+
+  auto it_reaction_and_category = reactions_and_categories.cbegin();
+  for (auto& add_reaction : add_reactions) {
+    auto const add_reaction_confirmation = co_await add_reaction;
+    if (add_reaction_confirmation.is_error()) {
+      logger_.Error("Failed to add awards reaction '{}' in nomination message '{}' to user '{}. Error: '{}'", it_reaction_and_category->first, sent_message.id.str(), user_id.str(), add_reaction_confirmation.get_error().human_readable);
+    }
+    ++it_reaction_and_category;
+  }
+}
+
+dpp::message MessageHandler::BuildNominationsMessage(dpp::snowflake const guild_id, std::string const& category) const noexcept {
+  auto constexpr kMaxMessageLength = 2000ULL;
+  auto constexpr kEntriesPerCategory = 3ULL;
+  auto constexpr kEntriesForSingleCategory = 10ULL;
+
+  auto const categories = category.empty() ? awards_tally_->GetCategories(guild_id) : std::vector<std::string>{category};
+  auto const limit = category.empty() ? kEntriesPerCategory : kEntriesForSingleCategory;
+
+  std::string nominations;
+  for (auto const& name : categories) {
+    auto const entries = awards_tally_->GetLatestNominations(guild_id, name, limit);
+    auto section = std::format("**{}**\n", name);
+    if (entries.empty()) {
+      section.append("Nenhuma indicação.\n");
+    }
+    for (auto const& entry : entries) {
+      section.append(std::format("- <{}>\n", entry.clip_url));
+    }
+
+    if (nominations.size() + section.size() > kMaxMessageLength) {
+      break;
+    }
+    nominations.append(section);
+  }
+
+  return dpp::message(nominations.empty() ? std::string("Nenhuma indicação registrada.") : nominations);
+}
+
+dpp::message MessageHandler::BuildTallyExportMessage(dpp::snowflake const guild_id) const noexcept {
+  return dpp::message("Todas as indicações do Awards.").add_file("indicacoes.csv", awards_tally_->Export(guild_id), "text/csv");
 }
\ No newline at end of file
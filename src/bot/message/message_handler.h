@@ -1,36 +1,67 @@
 #pragma once
 
+#include <map>
 #include <memory>
+#include <mutex>
 #include <regex>
 #include <string>
+#include <string_view>
 #include <vector>
 
 #include <dpp/dpp.h>
 
+#include "admission/user_throttle.h"
+#include "awards/awards_tally.h"
+#include "clip/clip_index.h"
+#include "command_router.h"
+#include "deletion_scheduler.h"
+#include "direct_messenger.h"
 #include "logger/logger_factory.h"
+#include "message_event.h"
+#include "rest/rest.h"
 
 class MessageHandler final {
 public:
   MessageHandler() = delete;
   ~MessageHandler() = default;
 
-  MessageHandler(std::shared_ptr<dpp::cluster> bot) noexcept;
+  MessageHandler(std::shared_ptr<Rest> rest, std::shared_ptr<DeletionScheduler> deletion_scheduler, std::shared_ptr<ClipIndex> clip_index,
+                 std::shared_ptr<AwardsTally> awards_tally, std::shared_ptr<DirectMessenger> direct_messenger, std::shared_ptr<UserThrottle> user_throttle) noexcept;
 
-  void Process(dpp::message const& message) noexcept;
-  void ProcessAnnouncementMessage(dpp::snowflake channel_id, std::string const& content) const noexcept;
-  void ProcessGeneralMessage(dpp::snowflake channel_id, std::string const& content) const noexcept;
-  void ProcessStreamingMessage(dpp::snowflake user_id, dpp::snowflake message_id, std::string const& content) noexcept;
-  void ProcessAwardsMessage(dpp::snowflake user_id, dpp::snowflake message_id, std::string const& content, std::vector<dpp::attachment> const& attachments) noexcept;
+  std::vector<dpp::slashcommand> GetSlashCommands(dpp::snowflake application_id) const;
+
+  bool IsRoutable(dpp::message const& message) const noexcept;
+  bool IsPermitted(dpp::slashcommand_t const& slash_command) const noexcept;
+  dpp::task<void> Process(MessageEvent const& message) noexcept;
+  dpp::task<void> Process(dpp::slashcommand_t const& slash_command) noexcept;
+  dpp::task<bool> ProcessAnnouncementMessage(dpp::snowflake channel_id, std::string const& text) const noexcept;
+  dpp::task<bool> ProcessGeneralMessage(dpp::snowflake channel_id, std::string const& text) const noexcept;
+  void ProcessStreamingMessage(dpp::snowflake channel_id, dpp::snowflake user_id, dpp::snowflake message_id, std::string const& content) noexcept;
+  dpp::task<void> ProcessAwardsMessage(dpp::snowflake guild_id, dpp::snowflake user_id, dpp::snowflake message_id, std::string const& content, std::vector<std::string> const& video_urls) noexcept;
+
+  dpp::snowflake FindNominationGuildId(dpp::snowflake nomination_message_id) const noexcept;
 
 private:
-  void SendNominationMessage(dpp::snowflake const user_id, std::string const& clip_url) noexcept;
+  dpp::task<void> SendNominationMessage(dpp::snowflake const guild_id, dpp::snowflake const user_id, std::string_view clip_url) noexcept;
+  dpp::message BuildNominationsMessage(dpp::snowflake guild_id, std::string const& category) const noexcept;
+  dpp::message BuildTallyExportMessage(dpp::snowflake guild_id) const noexcept;
 
 private:
   Logger const logger_ = LoggerFactory::Get().Create("Message Handler");
 
-  std::shared_ptr<dpp::cluster> const bot_;
+  std::shared_ptr<Rest> const rest_;
+  std::shared_ptr<DeletionScheduler> const deletion_scheduler_;
+  std::shared_ptr<ClipIndex> const clip_index_;
+  std::shared_ptr<AwardsTally> const awards_tally_;
+  std::shared_ptr<DirectMessenger> const direct_messenger_;
+  std::shared_ptr<UserThrottle> const user_throttle_;
+
+  CommandRouter command_router_;
 
   std::regex const url_regex_ = std::regex("((http|https)://)(www.)?[a-zA-Z0-9@:%._\\+~#?&//=]{2,256}\\.[a-z]{2,6}\\b([-a-zA-Z0-9@:%._\\+~#?&//=]*)");
 
-  std::string nomination_content_header_;
+  std::map<dpp::snowflake, std::string> nomination_content_headers_;
+
+  std::map<dpp::snowflake, dpp::snowflake> nomination_messages_guilds_ids_;
+  mutable std::mutex nomination_messages_guilds_ids_mutex_;
 };
\ No newline at end of file
@@ -0,0 +1,53 @@
+#include "allocation_counter.h"
+
+#include <atomic>
+#include <cstdlib>
+#include <new>
+
+namespace {
+  thread_local uint64_t thread_allocations{};
+  std::atomic<uint64_t> process_allocations{};
+}
+
+#if defined(SM64BR_COUNT_ALLOCATIONS)
+// The array and nothrow forms of operator new call this one, so they are counted too.
+void* operator new(std::size_t const bytes) {
+  ++::thread_allocations;
+  ::process_allocations.fetch_add(1, std::memory_order_relaxed);
+  while (true) {
+    if (auto* const memory = std::malloc((0 == bytes) ? 1 : bytes)) {
+      return memory;
+    }
+
+    auto const new_handler = std::get_new_handler();
+    if (nullptr == new_handler) {
+      throw std::bad_alloc();
+    }
+    new_handler();
+  }
+}
+
+void operator delete(void* const memory) noexcept {
+  std::free(memory);
+}
+
+void operator delete(void* const memory, std::size_t) noexcept {
+  std::free(memory);
+}
+#endif
+
+bool AllocationCounter::IsEnabled() noexcept {
+#if defined(SM64BR_COUNT_ALLOCATIONS)
+  return true;
+#else
+  return false;
+#endif
+}
+
+uint64_t AllocationCounter::GetThread() noexcept {
+  return ::thread_allocations;
+}
+
+uint64_t AllocationCounter::GetProcess() noexcept {
+  return ::process_allocations.load(std::memory_order_relaxed);
+}
\ No newline at end of file
@@ -0,0 +1,15 @@
+#pragma once
+
+#include <cstdint>
+
+// Counts heap allocations made through the global operator new. Counting replaces the global
+// operator new, so it is only compiled in with the SM64BR_COUNT_ALLOCATIONS CMake option and the
+// shipped binary keeps the stock allocator; otherwise every count stays at zero.
+struct AllocationCounter {
+  static bool IsEnabled() noexcept;
+
+  // Allocations made by the calling thread.
+  static uint64_t GetThread() noexcept;
+  // Allocations made by every thread.
+  static uint64_t GetProcess() noexcept;
+};
\ No newline at end of file
@@ -0,0 +1,80 @@
+#include "latency_histogram.h"
+
+#include <bit>
+#include <algorithm>
+#include <cmath>
+
+LatencyHistogram::Scope::Scope(LatencyHistogram& histogram, std::chrono::steady_clock::time_point const start) noexcept :
+  histogram_(histogram),
+  start_(start) {
+
+}
+
+LatencyHistogram::Scope::~Scope() {
+  histogram_.Record(std::chrono::steady_clock::now() - start_);
+}
+
+void LatencyHistogram::Record(std::chrono::nanoseconds const latency) noexcept {
+  auto const microseconds = static_cast<uint64_t>(std::max<long long>(0, std::chrono::duration_cast<std::chrono::microseconds>(latency).count()));
+  buckets_[BucketIndex(microseconds)].fetch_add(1, std::memory_order_relaxed);
+  count_.fetch_add(1, std::memory_order_relaxed);
+
+  auto max_microseconds = max_microseconds_.load(std::memory_order_relaxed);
+  while (max_microseconds < microseconds && !max_microseconds_.compare_exchange_weak(max_microseconds, microseconds, std::memory_order_relaxed)) {
+  }
+}
+
+void LatencyHistogram::Reset() noexcept {
+  for (auto& bucket : buckets_) {
+    bucket.store(0, std::memory_order_relaxed);
+  }
+  count_.store(0, std::memory_order_relaxed);
+  max_microseconds_.store(0, std::memory_order_relaxed);
+}
+
+std::size_t LatencyHistogram::GetCount() const noexcept {
+  return count_.load(std::memory_order_relaxed);
+}
+
+std::chrono::microseconds LatencyHistogram::GetPercentile(double const percentile) const noexcept {
+  auto const count = count_.load(std::memory_order_relaxed);
+  if (0 == count) {
+    return {};
+  }
+
+  auto const rank = static_cast<uint64_t>(std::ceil(std::clamp(percentile, 0.0, 1.0) * static_cast<double>(count)));
+  uint64_t seen{};
+  for (std::size_t index = 0; index < kBuckets; ++index) {
+    seen += buckets_[index].load(std::memory_order_relaxed);
+    if (seen >= rank && 0 != seen) {
+      return std::chrono::microseconds(std::min(BucketUpperBound(index), max_microseconds_.load(std::memory_order_relaxed)));
+    }
+  }
+
+  return GetMax();
+}
+
+std::chrono::microseconds LatencyHistogram::GetMax() const noexcept {
+  return std::chrono::microseconds(max_microseconds_.load(std::memory_order_relaxed));
+}
+
+std::size_t LatencyHistogram::BucketIndex(uint64_t const microseconds) noexcept {
+  if (microseconds < kSubBuckets) {
+    return static_cast<std::size_t>(microseconds);
+  }
+
+  auto const magnitude = static_cast<std::size_t>(std::bit_width(microseconds)) - 1;
+  auto const sub_bucket = static_cast<std::size_t>(microseconds >> (magnitude - kSubBucketBits)) & (kSubBuckets - 1);
+  return std::min(kBuckets - 1, (magnitude - kSubBucketBits + 1) * kSubBuckets + sub_bucket);
+}
+
+uint64_t LatencyHistogram::BucketUpperBound(std::size_t const index) noexcept {
+  if (index < kSubBuckets) {
+    return index;
+  }
+
+  auto const magnitude = index / kSubBuckets + kSubBucketBits - 1;
+  auto const sub_bucket = index % kSubBuckets;
+  auto const bucket_width = 1ULL << (magnitude - kSubBucketBits);
+  return ((kSubBuckets + sub_bucket) << (magnitude - kSubBucketBits)) + bucket_width - 1;
+}
\ No newline at end of file
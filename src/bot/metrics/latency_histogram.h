@@ -0,0 +1,49 @@
+#pragma once
+
+#include <array>
+#include <atomic>
+#include <chrono>
+#include <cstddef>
+#include <cstdint>
+
+// Fixed-size log-linear histogram so latency can be recorded from any thread for the lifetime
+// of the process without growing. Percentiles are reported as the upper bound of their bucket.
+class LatencyHistogram final {
+public:
+  class Scope final {
+  public:
+    Scope() = delete;
+    ~Scope();
+
+    Scope(LatencyHistogram& histogram, std::chrono::steady_clock::time_point start) noexcept;
+
+    Scope(Scope const&) = delete;
+    void operator=(Scope const&) = delete;
+
+  private:
+    LatencyHistogram& histogram_;
+    std::chrono::steady_clock::time_point const start_;
+  };
+
+  LatencyHistogram() = default;
+  ~LatencyHistogram() = default;
+
+  void Record(std::chrono::nanoseconds latency) noexcept;
+  void Reset() noexcept;
+
+  std::size_t GetCount() const noexcept;
+  std::chrono::microseconds GetPercentile(double percentile) const noexcept;
+  std::chrono::microseconds GetMax() const noexcept;
+
+private:
+  static constexpr std::size_t kSubBucketBits = 3;
+  static constexpr std::size_t kSubBuckets = 1ULL << kSubBucketBits;
+  static constexpr std::size_t kBuckets = 64 * kSubBuckets;
+
+  static std::size_t BucketIndex(uint64_t microseconds) noexcept;
+  static uint64_t BucketUpperBound(std::size_t index) noexcept;
+
+  std::array<std::atomic<uint64_t>, kBuckets> buckets_{};
+  std::atomic<uint64_t> count_{};
+  std::atomic<uint64_t> max_microseconds_{};
+};
\ No newline at end of file
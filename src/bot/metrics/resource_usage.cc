@@ -0,0 +1,37 @@
+#include "resource_usage.h"
+
+#include <fstream>
+
+#include <sys/resource.h>
+#include <unistd.h>
+
+namespace {
+  std::chrono::microseconds TimevalToMicroseconds(timeval const& time) {
+    return std::chrono::seconds(time.tv_sec) + std::chrono::microseconds(time.tv_usec);
+  }
+}
+
+ResourceUsage ResourceUsage::Sample() noexcept {
+  ResourceUsage resource_usage{};
+
+  rusage usage{};
+  if (0 == getrusage(RUSAGE_SELF, &usage)) {
+    resource_usage.cpu_time = ::TimevalToMicroseconds(usage.ru_utime) + ::TimevalToMicroseconds(usage.ru_stime);
+#if defined(__APPLE__)
+    resource_usage.peak_resident_bytes = static_cast<std::size_t>(usage.ru_maxrss);
+#else
+    resource_usage.peak_resident_bytes = static_cast<std::size_t>(usage.ru_maxrss) * 1024;
+#endif
+  }
+
+  std::ifstream statm("/proc/self/statm");
+  std::size_t total_pages{};
+  std::size_t resident_pages{};
+  if (statm >> total_pages >> resident_pages) {
+    resource_usage.resident_bytes = resident_pages * static_cast<std::size_t>(sysconf(_SC_PAGESIZE));
+  } else {
+    resource_usage.resident_bytes = resource_usage.peak_resident_bytes;
+  }
+
+  return resource_usage;
+}
\ No newline at end of file
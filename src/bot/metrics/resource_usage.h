@@ -0,0 +1,12 @@
+#pragma once
+
+#include <chrono>
+#include <cstddef>
+
+struct ResourceUsage {
+  std::chrono::microseconds cpu_time{};
+  std::size_t resident_bytes{};
+  std::size_t peak_resident_bytes{};
+
+  static ResourceUsage Sample() noexcept;
+};
\ No newline at end of file
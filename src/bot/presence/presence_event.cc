@@ -0,0 +1,20 @@
+#include "presence_event.h"
+
+#include <algorithm>
+
+PresenceEvent PresenceEvent::FromPresence(dpp::presence const& presence, StreamMatcher const& stream_matcher) {
+  PresenceEvent presence_event;
+  presence_event.guild_id = presence.guild_id;
+  presence_event.user_id = presence.user_id;
+
+  auto const& activities = presence.activities;
+  auto const streaming_activity = std::ranges::find_if(activities, [&stream_matcher](auto const& activity) { return stream_matcher.Matches(activity); });
+  if (activities.cend() != streaming_activity) {
+    presence_event.stream = Stream{.details = streaming_activity->details, .url = streaming_activity->url};
+  }
+  return presence_event;
+}
+
+std::size_t PresenceEvent::GetBytes() const noexcept {
+  return sizeof(PresenceEvent) + (stream ? (stream->details.capacity() + stream->url.capacity()) : 0);
+}
\ No newline at end of file
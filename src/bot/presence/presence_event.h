@@ -0,0 +1,36 @@
+#pragma once
+
+#include <cstddef>
+#include <optional>
+#include <string>
+
+#include <dpp/dpp.h>
+
+#include "stream_matcher.h"
+
+// The part of a presence update the streaming handler needs: who it is for and, when one of their
+// activities is a stream the bot announces, that stream's title and URL. Activities are matched on
+// the gateway thread, so the rest of them are never copied to the workers.
+struct PresenceEvent {
+  struct Stream {
+    std::string details;
+    std::string url;
+  };
+
+  dpp::snowflake guild_id;
+  dpp::snowflake user_id;
+  std::optional<Stream> stream;
+
+  PresenceEvent() = default;
+  ~PresenceEvent() = default;
+
+  PresenceEvent(PresenceEvent const&) = delete;
+  PresenceEvent& operator=(PresenceEvent const&) = delete;
+  PresenceEvent(PresenceEvent&&) noexcept = default;
+  PresenceEvent& operator=(PresenceEvent&&) noexcept = default;
+
+  static PresenceEvent FromPresence(dpp::presence const& presence, StreamMatcher const& stream_matcher);
+
+  // Bytes held by the event, inline and on the heap.
+  std::size_t GetBytes() const noexcept;
+};
\ No newline at end of file
@@ -0,0 +1,184 @@
+#include "stream_matcher.h"
+
+#include <algorithm>
+#include <cctype>
+#include <format>
+#include <iterator>
+#include <queue>
+#include <stdexcept>
+#include <utility>
+
+namespace {
+  auto constexpr kPlatformHit = uint8_t{1 << 0};
+  auto constexpr kGameHit = uint8_t{1 << 1};
+  auto constexpr kKeywordHit = uint8_t{1 << 2};
+  auto constexpr kExclusionHit = uint8_t{1 << 3};
+
+  auto constexpr kNoState = UINT32_MAX;
+  auto constexpr kMaxCharacterClasses = std::size_t{256};
+}
+
+StreamMatcher::StreamMatcher(std::vector<Settings::StreamRule> const& rules) {
+  if (rules.size() > kMaxRules) {
+    throw std::runtime_error(std::format("Too many stream rules ({}), at most {} are supported", rules.size(), kMaxRules));
+  }
+
+  std::vector<std::pair<std::vector<uint8_t>, Output>> patterns;
+  for (std::size_t rule_index = 0; rule_index < rules.size(); ++rule_index) {
+    auto const& rule = rules[rule_index];
+    auto const output = [rule_index](PatternKind const kind) { return Output{.rule_index = static_cast<uint32_t>(rule_index), .kind = kind}; };
+
+    patterns.emplace_back(Encode(rule.platform, true), output(PatternKind::kPlatform));
+    std::ranges::for_each(rule.games, [this, &patterns, &output](auto const& game) { patterns.emplace_back(Encode(game, true), output(PatternKind::kGame)); });
+    std::ranges::for_each(rule.keywords, [this, &patterns, &output](auto const& keyword) { patterns.emplace_back(Encode(keyword, false), output(PatternKind::kKeyword)); });
+    std::ranges::for_each(rule.exclusions, [this, &patterns, &output](auto const& exclusion) { patterns.emplace_back(Encode(exclusion, false), output(PatternKind::kExclusion)); });
+
+    rules_.push_back(RuleRequirements{.needs_game = !rule.games.empty(), .needs_keyword = !rule.keywords.empty()});
+  }
+
+  Trie trie(1, std::vector<uint32_t>(class_count_, kNoState));
+  outputs_.emplace_back();
+  std::ranges::for_each(patterns, [this, &trie](auto const& pattern_and_output) { AddPattern(trie, pattern_and_output.first, pattern_and_output.second); });
+
+  Compile(trie);
+}
+
+bool StreamMatcher::Matches(dpp::activity const& activity) const noexcept {
+  if ((dpp::activity_type::at_streaming != activity.type) || rules_.empty()) {
+    return false;
+  }
+
+  RuleHits rule_hits{};
+  uint32_t state{};
+  std::size_t separators{};
+  for (auto const* field : {&activity.name, &activity.state, &activity.details}) {
+    Feed(kSeparatorClass, state, separators, rule_hits);
+    std::ranges::for_each(*field, [this, &state, &separators, &rule_hits](char const character) {
+      Feed(character_classes_[static_cast<uint8_t>(character)], state, separators, rule_hits);
+    });
+  }
+  Feed(kSeparatorClass, state, separators, rule_hits);
+
+  for (std::size_t rule_index = 0; rule_index < rules_.size(); ++rule_index) {
+    auto const& rule = rules_[rule_index];
+    auto const hits = rule_hits[rule_index];
+    auto const platform_matches = 0 != (hits & ::kPlatformHit);
+    auto const game_matches = !rule.needs_game || (0 != (hits & ::kGameHit));
+    auto const keyword_matches = !rule.needs_keyword || (0 != (hits & ::kKeywordHit));
+    auto const excluded = 0 != (hits & ::kExclusionHit);
+    if (platform_matches && game_matches && keyword_matches && !excluded) {
+      return true;
+    }
+  }
+
+  return false;
+}
+
+std::vector<uint8_t> StreamMatcher::Encode(std::string_view const text, bool const add_separators) {
+  std::vector<uint8_t> pattern;
+  if (add_separators) {
+    pattern.push_back(kSeparatorClass);
+  }
+
+  for (auto const character : text) {
+    auto const lower = static_cast<uint8_t>(std::tolower(static_cast<unsigned char>(character)));
+    if (kOtherClass == character_classes_[lower]) {
+      if (kMaxCharacterClasses == class_count_) {
+        throw std::runtime_error("Too many distinct characters in stream rules");
+      }
+
+      auto const character_class = static_cast<uint8_t>(class_count_++);
+      character_classes_[lower] = character_class;
+      character_classes_[static_cast<uint8_t>(std::toupper(lower))] = character_class;
+    }
+
+    pattern.push_back(character_classes_[lower]);
+  }
+
+  if (add_separators) {
+    pattern.push_back(kSeparatorClass);
+  }
+
+  return pattern;
+}
+
+void StreamMatcher::AddPattern(Trie& trie, std::vector<uint8_t> const& pattern, Output const output) {
+  uint32_t node{};
+  for (auto const character_class : pattern) {
+    if (kNoState == trie[node][character_class]) {
+      trie[node][character_class] = static_cast<uint32_t>(trie.size());
+      trie.emplace_back(class_count_, kNoState);
+      outputs_.emplace_back();
+    }
+
+    node = trie[node][character_class];
+  }
+
+  outputs_[node].push_back(output);
+}
+
+void StreamMatcher::Compile(Trie const& trie) {
+  transitions_.assign(trie.size() * class_count_, 0);
+  std::vector<uint32_t> failures(trie.size(), 0);
+
+  std::queue<uint32_t> pending_nodes;
+  for (std::size_t character_class = 0; character_class < class_count_; ++character_class) {
+    auto const child = trie[0][character_class];
+    if (kNoState != child) {
+      transitions_[character_class] = child;
+      pending_nodes.push(child);
+    }
+  }
+
+  while (!pending_nodes.empty()) {
+    auto const node = pending_nodes.front();
+    pending_nodes.pop();
+
+    auto const failure = failures[node];
+    std::ranges::copy(outputs_[failure], std::back_inserter(outputs_[node]));
+
+    for (std::size_t character_class = 0; character_class < class_count_; ++character_class) {
+      auto const child = trie[node][character_class];
+      auto const failure_transition = transitions_[failure * class_count_ + character_class];
+      if (kNoState != child) {
+        failures[child] = failure_transition;
+        transitions_[node * class_count_ + character_class] = child;
+        pending_nodes.push(child);
+      } else {
+        transitions_[node * class_count_ + character_class] = failure_transition;
+      }
+    }
+  }
+}
+
+void StreamMatcher::Feed(uint8_t const character_class, uint32_t& state, std::size_t& separators, RuleHits& rule_hits) const noexcept {
+  auto constexpr kNameEnd = 2ULL;
+  auto constexpr kStateEnd = 3ULL;
+
+  if (kSeparatorClass == character_class) {
+    ++separators;
+  }
+
+  state = transitions_[state * class_count_ + character_class];
+  for (auto const& output : outputs_[state]) {
+    auto& hits = rule_hits[output.rule_index];
+    switch (output.kind) {
+      case PatternKind::kPlatform: {
+        hits |= (kNameEnd == separators) ? ::kPlatformHit : 0;
+        break;
+      }
+      case PatternKind::kGame: {
+        hits |= (kStateEnd == separators) ? ::kGameHit : 0;
+        break;
+      }
+      case PatternKind::kKeyword: {
+        hits |= (kStateEnd == separators) ? ::kKeywordHit : 0;
+        break;
+      }
+      case PatternKind::kExclusion: {
+        hits |= ((kNameEnd == separators) || (kStateEnd == separators)) ? ::kExclusionHit : 0;
+        break;
+      }
+    }
+  }
+}
\ No newline at end of file
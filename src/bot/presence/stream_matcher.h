@@ -0,0 +1,70 @@
+#pragma once
+
+#include <array>
+#include <cstddef>
+#include <cstdint>
+#include <string>
+#include <string_view>
+#include <vector>
+
+#include <dpp/dpp.h>
+
+#include "settings/settings.h"
+
+// Decides whether a presence activity is a stream the bot should announce. All rule patterns are
+// compiled at load time into a single Aho-Corasick automaton over case-folded character classes,
+// so every activity is scanned once (name, state and details, split by a separator symbol that no
+// input byte maps to) no matter how many rules there are. A rule matches when its platform equals
+// the activity name, its game (if any) equals the state, one of its keywords (if any) appears in the
+// details and none of its exclusions appear in the state or details.
+class StreamMatcher final {
+public:
+  // Matching keeps one hit mask per rule on the stack, so Matches never allocates.
+  static constexpr std::size_t kMaxRules = 64;
+
+  StreamMatcher() = delete;
+  ~StreamMatcher() = default;
+
+  StreamMatcher(std::vector<Settings::StreamRule> const& rules);
+
+  bool Matches(dpp::activity const& activity) const noexcept;
+
+private:
+  enum class PatternKind : uint8_t {
+    kPlatform,
+    kGame,
+    kKeyword,
+    kExclusion
+  };
+
+  struct Output {
+    uint32_t rule_index{};
+    PatternKind kind{};
+  };
+
+  struct RuleRequirements {
+    bool needs_game{};
+    bool needs_keyword{};
+  };
+
+  static constexpr uint8_t kOtherClass = 0;
+  static constexpr uint8_t kSeparatorClass = 1;
+
+  using Trie = std::vector<std::vector<uint32_t>>;
+  using RuleHits = std::array<uint8_t, kMaxRules>;
+
+  std::vector<uint8_t> Encode(std::string_view text, bool add_separators);
+  void AddPattern(Trie& trie, std::vector<uint8_t> const& pattern, Output output);
+  void Compile(Trie const& trie);
+
+  void Feed(uint8_t character_class, uint32_t& state, std::size_t& separators, RuleHits& rule_hits) const noexcept;
+
+private:
+  std::array<uint8_t, 256> character_classes_{};
+  std::size_t class_count_ = kSeparatorClass + 1;
+
+  std::vector<uint32_t> transitions_;
+  std::vector<std::vector<Output>> outputs_;
+
+  std::vector<RuleRequirements> rules_;
+};
\ No newline at end of file
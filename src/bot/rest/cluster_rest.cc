@@ -0,0 +1,69 @@
+#include "cluster_rest.h"
+
+#include <mutex>
+#include <utility>
+
+namespace {
+  dpp::command_completion_event_t OrLogError(dpp::command_completion_event_t&& callback) {
+    return callback ? std::move(callback) : dpp::utility::log_error();
+  }
+}
+
+ClusterRest::ClusterRest(std::shared_ptr<dpp::cluster> bot) noexcept :
+  bot_(std::move(bot)) {
+
+}
+
+void ClusterRest::GuildGetMembers(dpp::snowflake const guild_id, uint16_t const limit, dpp::snowflake const after, dpp::command_completion_event_t callback) {
+  bot_->guild_get_members(guild_id, limit, after, Gate(std::move(callback)));
+}
+
+void ClusterRest::GuildMemberAddRole(dpp::snowflake const guild_id, dpp::snowflake const user_id, dpp::snowflake const role_id, dpp::command_completion_event_t callback) {
+  bot_->guild_member_add_role(guild_id, user_id, role_id, Gate(std::move(callback)));
+}
+
+void ClusterRest::GuildMemberRemoveRole(dpp::snowflake const guild_id, dpp::snowflake const user_id, dpp::snowflake const role_id, dpp::command_completion_event_t callback) {
+  bot_->guild_member_remove_role(guild_id, user_id, role_id, Gate(std::move(callback)));
+}
+
+void ClusterRest::MessageCreate(dpp::message const& message, dpp::command_completion_event_t callback) {
+  bot_->message_create(message, Gate(std::move(callback)));
+}
+
+void ClusterRest::MessageEdit(dpp::message const& message, dpp::command_completion_event_t callback) {
+  bot_->message_edit(message, Gate(std::move(callback)));
+}
+
+void ClusterRest::MessageDelete(dpp::snowflake const message_id, dpp::snowflake const channel_id, dpp::command_completion_event_t callback) {
+  bot_->message_delete(message_id, channel_id, Gate(std::move(callback)));
+}
+
+void ClusterRest::MessageGet(dpp::snowflake const message_id, dpp::snowflake const channel_id, dpp::command_completion_event_t callback) {
+  bot_->message_get(message_id, channel_id, Gate(std::move(callback)));
+}
+
+void ClusterRest::MessagesGet(dpp::snowflake const channel_id, dpp::snowflake const around, dpp::snowflake const before, dpp::snowflake const after, uint64_t const limit, dpp::command_completion_event_t callback) {
+  bot_->messages_get(channel_id, around, before, after, limit, Gate(std::move(callback)));
+}
+
+void ClusterRest::MessageAddReaction(dpp::snowflake const message_id, dpp::snowflake const channel_id, std::string const& reaction, dpp::command_completion_event_t callback) {
+  bot_->message_add_reaction(message_id, channel_id, reaction, Gate(std::move(callback)));
+}
+
+void ClusterRest::CreateDmChannel(dpp::snowflake const user_id, dpp::command_completion_event_t callback) {
+  bot_->create_dm_channel(user_id, Gate(std::move(callback)));
+}
+
+void ClusterRest::Close() noexcept {
+  std::unique_lock<std::shared_mutex> const gate_lock(callback_gate_->mutex);
+  callback_gate_->open = false;
+}
+
+dpp::command_completion_event_t ClusterRest::Gate(dpp::command_completion_event_t&& callback) const {
+  return [callback_gate = callback_gate_, callback = ::OrLogError(std::move(callback))](dpp::confirmation_callback_t const& confirmation) {
+    std::shared_lock<std::shared_mutex> const gate_lock(callback_gate->mutex);
+    if (callback_gate->open) {
+      callback(confirmation);
+    }
+  };
+}
\ No newline at end of file
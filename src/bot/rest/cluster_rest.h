@@ -0,0 +1,42 @@
+#pragma once
+
+#include <memory>
+#include <shared_mutex>
+
+#include <dpp/dpp.h>
+
+#include "rest.h"
+
+class ClusterRest final : public Rest {
+public:
+  ClusterRest() = delete;
+  ~ClusterRest() override = default;
+
+  ClusterRest(std::shared_ptr<dpp::cluster> bot) noexcept;
+
+  void GuildGetMembers(dpp::snowflake guild_id, uint16_t limit, dpp::snowflake after, dpp::command_completion_event_t callback) override;
+  void GuildMemberAddRole(dpp::snowflake guild_id, dpp::snowflake user_id, dpp::snowflake role_id, dpp::command_completion_event_t callback) override;
+  void GuildMemberRemoveRole(dpp::snowflake guild_id, dpp::snowflake user_id, dpp::snowflake role_id, dpp::command_completion_event_t callback) override;
+  void MessageCreate(dpp::message const& message, dpp::command_completion_event_t callback) override;
+  void MessageEdit(dpp::message const& message, dpp::command_completion_event_t callback) override;
+  void MessageDelete(dpp::snowflake message_id, dpp::snowflake channel_id, dpp::command_completion_event_t callback) override;
+  void MessageGet(dpp::snowflake message_id, dpp::snowflake channel_id, dpp::command_completion_event_t callback) override;
+  void MessagesGet(dpp::snowflake channel_id, dpp::snowflake around, dpp::snowflake before, dpp::snowflake after, uint64_t limit, dpp::command_completion_event_t callback) override;
+  void MessageAddReaction(dpp::snowflake message_id, dpp::snowflake channel_id, std::string const& reaction, dpp::command_completion_event_t callback) override;
+  void CreateDmChannel(dpp::snowflake user_id, dpp::command_completion_event_t callback) override;
+
+  void Close() noexcept override;
+
+private:
+  // Completions hold the gate shared while they run, and Close takes it exclusively to shut it.
+  struct CallbackGate {
+    std::shared_mutex mutex;
+    bool open = true;
+  };
+
+  dpp::command_completion_event_t Gate(dpp::command_completion_event_t&& callback) const;
+
+private:
+  std::shared_ptr<dpp::cluster> const bot_;
+  std::shared_ptr<CallbackGate> const callback_gate_ = std::make_shared<CallbackGate>();
+};
\ No newline at end of file
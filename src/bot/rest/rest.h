@@ -0,0 +1,60 @@
+#pragma once
+
+#include <cstdint>
+#include <string>
+
+#include <dpp/dpp.h>
+
+// REST surface used by the bot. Mirrors the dpp::cluster calls so handlers can run against
+// the live API (ClusterRest) or the offline stand-in used by the replay harness (RestStandIn).
+class Rest {
+public:
+  virtual ~Rest() = default;
+
+  virtual void GuildGetMembers(dpp::snowflake guild_id, uint16_t limit, dpp::snowflake after, dpp::command_completion_event_t callback = {}) = 0;
+  virtual void GuildMemberAddRole(dpp::snowflake guild_id, dpp::snowflake user_id, dpp::snowflake role_id, dpp::command_completion_event_t callback = {}) = 0;
+  virtual void GuildMemberRemoveRole(dpp::snowflake guild_id, dpp::snowflake user_id, dpp::snowflake role_id, dpp::command_completion_event_t callback = {}) = 0;
+  virtual void MessageCreate(dpp::message const& message, dpp::command_completion_event_t callback = {}) = 0;
+  virtual void MessageEdit(dpp::message const& message, dpp::command_completion_event_t callback = {}) = 0;
+  virtual void MessageDelete(dpp::snowflake message_id, dpp::snowflake channel_id, dpp::command_completion_event_t callback = {}) = 0;
+  virtual void MessageGet(dpp::snowflake message_id, dpp::snowflake channel_id, dpp::command_completion_event_t callback = {}) = 0;
+  virtual void MessagesGet(dpp::snowflake channel_id, dpp::snowflake around, dpp::snowflake before, dpp::snowflake after, uint64_t limit, dpp::command_completion_event_t callback = {}) = 0;
+  virtual void MessageAddReaction(dpp::snowflake message_id, dpp::snowflake channel_id, std::string const& reaction, dpp::command_completion_event_t callback = {}) = 0;
+  virtual void CreateDmChannel(dpp::snowflake user_id, dpp::command_completion_event_t callback = {}) = 0;
+
+  // Stops delivering completions and returns once none is running. Completions that arrive later
+  // are dropped, so coroutines still awaiting a call are never resumed on objects being destroyed.
+  virtual void Close() noexcept = 0;
+
+  dpp::async<dpp::confirmation_callback_t> CoGuildGetMembers(dpp::snowflake const guild_id, uint16_t const limit, dpp::snowflake const after) {
+    return dpp::async<dpp::confirmation_callback_t>{this, &Rest::GuildGetMembers, guild_id, limit, after};
+  }
+
+  dpp::async<dpp::confirmation_callback_t> CoGuildMemberRemoveRole(dpp::snowflake const guild_id, dpp::snowflake const user_id, dpp::snowflake const role_id) {
+    return dpp::async<dpp::confirmation_callback_t>{this, &Rest::GuildMemberRemoveRole, guild_id, user_id, role_id};
+  }
+
+  dpp::async<dpp::confirmation_callback_t> CoMessageCreate(dpp::message const& message) {
+    return dpp::async<dpp::confirmation_callback_t>{this, &Rest::MessageCreate, message};
+  }
+
+  dpp::async<dpp::confirmation_callback_t> CoMessageEdit(dpp::message const& message) {
+    return dpp::async<dpp::confirmation_callback_t>{this, &Rest::MessageEdit, message};
+  }
+
+  dpp::async<dpp::confirmation_callback_t> CoMessageDelete(dpp::snowflake const message_id, dpp::snowflake const channel_id) {
+    return dpp::async<dpp::confirmation_callback_t>{this, &Rest::MessageDelete, message_id, channel_id};
+  }
+
+  dpp::async<dpp::confirmation_callback_t> CoMessageGet(dpp::snowflake const message_id, dpp::snowflake const channel_id) {
+    return dpp::async<dpp::confirmation_callback_t>{this, &Rest::MessageGet, message_id, channel_id};
+  }
+
+  dpp::async<dpp::confirmation_callback_t> CoMessagesGet(dpp::snowflake const channel_id, dpp::snowflake const around, dpp::snowflake const before, dpp::snowflake const after, uint64_t const limit) {
+    return dpp::async<dpp::confirmation_callback_t>{this, &Rest::MessagesGet, channel_id, around, before, after, limit};
+  }
+
+  dpp::async<dpp::confirmation_callback_t> CoMessageAddReaction(dpp::snowflake const message_id, dpp::snowflake const channel_id, std::string const& reaction) {
+    return dpp::async<dpp::confirmation_callback_t>{this, &Rest::MessageAddReaction, message_id, channel_id, reaction};
+  }
+};
\ No newline at end of file
@@ -50,6 +50,18 @@ namespace {
     return Settings::Users::kNone;
   }
 
+  dpp::cache_policy_setting_t CachePolicyStringToEnum(std::string const& policy) noexcept {
+    if (policy == "none") {
+      return dpp::cp_none;
+    }
+
+    if (policy == "lazy") {
+      return dpp::cp_lazy;
+    }
+
+    return dpp::cp_aggressive;
+  }
+
   Settings::Categories CategoryStringToEnum(std::string const& category) noexcept {
     if (category == "0 Star") {
       return Settings::Categories::k0Star;
@@ -73,6 +85,41 @@ namespace {
 
     return Settings::Categories::kNone;
   }
+
+  Settings::LogOverflow LogOverflowStringToEnum(std::string const& overflow) noexcept {
+    if (overflow == "block") {
+      return Settings::LogOverflow::kBlock;
+    }
+
+    if (overflow == "drop_new") {
+      return Settings::LogOverflow::kDropNew;
+    }
+
+    return Settings::LogOverflow::kDropOldest;
+  }
+}
+
+dpp::snowflake Settings::Guild::GetGuildId() const noexcept {
+  return guild_id_;
+}
+
+dpp::snowflake Settings::Guild::GetChannelId(Channels const channel) const noexcept {
+  auto const it_channel_id = channels_ids_.find(channel);
+  return (channels_ids_.cend() != it_channel_id) ? it_channel_id->second : dpp::snowflake{};
+}
+
+dpp::snowflake Settings::Guild::GetRoleId(Roles const role) const noexcept {
+  auto const it_role_id = roles_ids_.find(role);
+  return (roles_ids_.cend() != it_role_id) ? it_role_id->second : dpp::snowflake{};
+}
+
+dpp::snowflake Settings::Guild::GetUserId(Users const user) const noexcept {
+  auto const it_user_id = users_ids_.find(user);
+  return (users_ids_.cend() != it_user_id) ? it_user_id->second : dpp::snowflake{};
+}
+
+std::map<std::string, std::string> const& Settings::Guild::GetAwardsReactionsAndCategories() const noexcept {
+  return awards_reactions_and_categories_;
 }
 
 Settings& Settings::Get() noexcept {
@@ -80,6 +127,26 @@ Settings& Settings::Get() noexcept {
   return settings;
 }
 
+Settings::Guild Settings::ParseGuild(nlohmann::json const& guild_json, nlohmann::json const& users_json, nlohmann::json const& awards_json) {
+  Guild guild;
+  guild.guild_id_ = guild_json["guild"].get<dpp::snowflake>();
+
+  auto const& channels_json = guild_json["channels"];
+  std::ranges::for_each(channels_json.items(), [&guild](auto const& channel_json) { guild.channels_ids_[::ServerChannelStringToEnum(channel_json.key())] = channel_json.value().template get<dpp::snowflake>(); });
+  guild.channels_ids_[Channels::kNone] = dpp::snowflake{};
+
+  auto const& roles_json = guild_json["roles"];
+  std::ranges::for_each(roles_json.items(), [&guild](auto const& role_json) { guild.roles_ids_[::ServerRoleStringToEnum(role_json.key())] = role_json.value().template get<dpp::snowflake>(); });
+  guild.roles_ids_[Roles::kNone] = dpp::snowflake{};
+
+  std::ranges::for_each(users_json.items(), [&guild](auto const& user_json) { guild.users_ids_[::UserStringToEnum(user_json.key())] = user_json.value().template get<dpp::snowflake>(); });
+  guild.users_ids_[Users::kNone] = dpp::snowflake{};
+
+  std::ranges::for_each(awards_json.items(), [&guild](auto const& award_json) { guild.awards_reactions_and_categories_[award_json.key()] = award_json.value(); });
+
+  return guild;
+}
+
 Settings::Settings() {
   std::ifstream settings_file("settings/settings.json");
   auto const settings_json = nlohmann::json::parse(settings_file);
@@ -87,23 +154,89 @@ Settings::Settings() {
   auto const& bot_data = settings_json["bot"];
   bot_token_ = bot_data["token"].get<std::string>();
 
-  auto const& server_data = settings_json["server"];
-  guild_id_ = server_data["guild"].get<dpp::snowflake>();
+  if (bot_data.contains("gateway")) {
+    auto const& gateway_json = bot_data["gateway"];
+    gateway_settings_.shards = gateway_json.value("shards", gateway_settings_.shards);
+    gateway_settings_.minimal_intents = gateway_json.value("minimal_intents", gateway_settings_.minimal_intents);
+    gateway_settings_.etf = gateway_json.value("etf", gateway_settings_.etf);
+    gateway_settings_.compression = gateway_json.value("compression", gateway_settings_.compression);
+    gateway_settings_.usage_report_interval = std::chrono::seconds(gateway_json.value("usage_report_interval_seconds", gateway_settings_.usage_report_interval.count()));
+
+    if (gateway_json.contains("health")) {
+      auto const& health_json = gateway_json["health"];
+      auto& health_settings = gateway_settings_.health;
+      health_settings.check_interval = std::chrono::milliseconds(health_json.value("check_interval_ms", health_settings.check_interval.count()));
+      health_settings.ack_timeout = std::chrono::seconds(health_json.value("ack_timeout_seconds", std::chrono::duration_cast<std::chrono::seconds>(health_settings.ack_timeout).count()));
+      health_settings.event_gap = std::chrono::seconds(health_json.value("event_gap_seconds", std::chrono::duration_cast<std::chrono::seconds>(health_settings.event_gap).count()));
+      health_settings.resume_timeout = std::chrono::seconds(health_json.value("resume_timeout_seconds", std::chrono::duration_cast<std::chrono::seconds>(health_settings.resume_timeout).count()));
+      health_settings.reconnect_timeout = std::chrono::seconds(health_json.value("reconnect_timeout_seconds", std::chrono::duration_cast<std::chrono::seconds>(health_settings.reconnect_timeout).count()));
+    }
+  }
+
+  if (bot_data.contains("cache")) {
+    auto const& cache_json = bot_data["cache"];
+    auto& dpp_policy = cache_settings_.dpp_policy;
+    dpp_policy.user_policy = ::CachePolicyStringToEnum(cache_json.value("users", std::string("aggressive")));
+    dpp_policy.emoji_policy = ::CachePolicyStringToEnum(cache_json.value("emojis", std::string("aggressive")));
+    dpp_policy.role_policy = ::CachePolicyStringToEnum(cache_json.value("roles", std::string("aggressive")));
+    dpp_policy.channel_policy = ::CachePolicyStringToEnum(cache_json.value("channels", std::string("aggressive")));
+    dpp_policy.guild_policy = ::CachePolicyStringToEnum(cache_json.value("guilds", std::string("aggressive")));
+    cache_settings_.user_budget_bytes = cache_json.value("user_budget_kib", cache_settings_.user_budget_bytes / 1024) * 1024;
+    cache_settings_.trim_interval = std::chrono::seconds(cache_json.value("trim_interval_seconds", cache_settings_.trim_interval.count()));
+  }
+
+  if (bot_data.contains("lifecycle")) {
+    auto const& lifecycle_json = bot_data["lifecycle"];
+    lifecycle_settings_.drain_deadline = std::chrono::seconds(lifecycle_json.value("drain_deadline_seconds", lifecycle_settings_.drain_deadline.count()));
+    lifecycle_settings_.state_path = lifecycle_json.value("state_path", lifecycle_settings_.state_path);
+    lifecycle_settings_.dm_channels_path = lifecycle_json.value("dm_channels_path", lifecycle_settings_.dm_channels_path);
+    lifecycle_settings_.leader_lock_path = lifecycle_json.value("leader_lock_path", lifecycle_settings_.leader_lock_path);
+    lifecycle_settings_.streams_path = lifecycle_json.value("streams_path", lifecycle_settings_.streams_path);
+    lifecycle_settings_.standby_poll_interval = std::chrono::milliseconds(lifecycle_json.value("standby_poll_interval_ms", lifecycle_settings_.standby_poll_interval.count()));
+  }
 
-  auto const& channels_json = server_data["channels"];
-  std::ranges::for_each(channels_json.items(), [this](auto const& channel_json) { channels_ids_[::ServerChannelStringToEnum(channel_json.key())] = channel_json.value().template get<dpp::snowflake>(); });
-  channels_ids_[Channels::kNone] = dpp::snowflake{};
+  if (bot_data.contains("admission")) {
+    auto const& admission_json = bot_data["admission"];
+    admission_settings_.command_concurrency = admission_json.value("command_concurrency", admission_settings_.command_concurrency);
+    admission_settings_.message_concurrency = admission_json.value("message_concurrency", admission_settings_.message_concurrency);
+    admission_settings_.presence_concurrency = admission_json.value("presence_concurrency", admission_settings_.presence_concurrency);
+    admission_settings_.presence_queue_limit = admission_json.value("presence_queue_limit", admission_settings_.presence_queue_limit);
+  }
 
-  auto const& roles_json = server_data["roles"];
-  std::ranges::for_each(roles_json.items(), [this](auto const& role_json) { roles_ids_[::ServerRoleStringToEnum(role_json.key())] = role_json.value().template get<dpp::snowflake>(); });
-  roles_ids_[Roles::kNone] = dpp::snowflake{};
+  if (bot_data.contains("throttle")) {
+    auto const& throttle_json = bot_data["throttle"];
+    for (auto const [key, rate] : {std::pair{"streaming_messages", &throttle_settings_.streaming_messages}, std::pair{"clip_links", &throttle_settings_.clip_links}, std::pair{"reactions", &throttle_settings_.reactions}}) {
+      if (throttle_json.contains(key)) {
+        rate->per_minute = throttle_json[key].value("per_minute", rate->per_minute);
+        rate->burst = throttle_json[key].value("burst", rate->burst);
+      }
+    }
+  }
 
-  auto const& users_json = settings_json["users"];
-  std::ranges::for_each(users_json.items(), [this](auto const& user_json) { users_ids_[::UserStringToEnum(user_json.key())] = user_json.value().template get<dpp::snowflake>(); });
-  users_ids_[Users::kNone] = dpp::snowflake{};
+  if (bot_data.contains("clips")) {
+    auto const& clips_json = bot_data["clips"];
+    clips_settings_.index_path = clips_json.value("index_path", clips_settings_.index_path);
+    clips_settings_.initial_capacity = clips_json.value("initial_capacity", clips_settings_.initial_capacity);
+    clips_settings_.tally_path = clips_json.value("tally_path", clips_settings_.tally_path);
+  }
 
-  auto const& awards_json = settings_json["awards"];
-  std::ranges::for_each(awards_json.items(), [this](auto const& award_json) { awards_reactions_and_categories_[award_json.key()] = award_json.value(); });
+  if (bot_data.contains("logging")) {
+    auto const& logging_json = bot_data["logging"];
+    logging_settings_.queue_size = logging_json.value("queue_size", logging_settings_.queue_size);
+    logging_settings_.overflow = ::LogOverflowStringToEnum(logging_json.value("overflow", std::string("drop_oldest")));
+    logging_settings_.repeat_window = std::chrono::seconds(logging_json.value("repeat_window_seconds", logging_settings_.repeat_window.count()));
+    logging_settings_.compress_rotated = logging_json.value("compress_rotated", logging_settings_.compress_rotated);
+  }
+
+  if (settings_json.contains("guilds")) {
+    std::ranges::for_each(settings_json["guilds"], [this](auto const& guild_json) {
+      auto guild = ParseGuild(guild_json, guild_json.value("users", nlohmann::json::object()), guild_json.value("awards", nlohmann::json::object()));
+      guilds_[guild.guild_id_] = std::move(guild);
+    });
+  } else {
+    auto guild = ParseGuild(settings_json.at("server"), settings_json.value("users", nlohmann::json::object()), settings_json.value("awards", nlohmann::json::object()));
+    guilds_[guild.guild_id_] = std::move(guild);
+  }
 
   auto const& the_run_data = settings_json["the_run"];
   the_run_endpoint_ = the_run_data["endpoint"].get<std::string>();
@@ -119,30 +252,108 @@ Settings::Settings() {
     the_run_thresholds_[category] = std::move(thresholds);
   });
   the_run_thresholds_[Categories::kNone] = {};
+
+  if (settings_json.contains("streams")) {
+    auto const& streams_json = settings_json["streams"];
+    streaming_message_lifetime_ = std::chrono::minutes(streams_json.value("message_lifetime_minutes", streaming_message_lifetime_.count()));
+    streaming_edit_interval_ = std::chrono::seconds(streams_json.value("edit_interval_seconds", streaming_edit_interval_.count()));
+
+    if (streams_json.contains("rules")) {
+      stream_rules_.clear();
+      std::ranges::for_each(streams_json["rules"], [this](auto const& rule_json) {
+        stream_rules_.push_back(StreamRule{
+          .platform = rule_json["platform"].template get<std::string>(),
+          .games = rule_json.value("games", std::vector<std::string>{}),
+          .keywords = rule_json.value("keywords", std::vector<std::string>{}),
+          .exclusions = rule_json.value("exclusions", std::vector<std::string>{})
+        });
+      });
+    }
+  }
+
+  if (settings_json.contains("updates")) {
+    auto const& updates_json = settings_json["updates"];
+    updates_settings_.burst_threshold = updates_json.value("burst_threshold", updates_settings_.burst_threshold);
+    updates_settings_.burst_window = std::chrono::seconds(updates_json.value("burst_window_seconds", updates_settings_.burst_window.count()));
+  }
+
+  if (settings_json.contains("harness")) {
+    auto const& harness_json = settings_json["harness"];
+    auto const rest_json = harness_json.value("rest", nlohmann::json::object());
+    harness_settings_.rest_latency = std::chrono::milliseconds(rest_json.value("latency_ms", 0LL));
+
+    auto const rate_limit_json = rest_json.value("rate_limit", nlohmann::json::object());
+    harness_settings_.rate_limit_requests = rate_limit_json.value("requests", std::size_t{});
+    harness_settings_.rate_limit_window = std::chrono::milliseconds(rate_limit_json.value("window_ms", 1000LL));
+
+    if (harness_json.contains("the_run_feed")) {
+      auto const& the_run_feed_json = harness_json["the_run_feed"];
+      auto& the_run_feed_settings = harness_settings_.the_run_feed;
+      the_run_feed_settings.port = the_run_feed_json.value("port", the_run_feed_settings.port);
+      the_run_feed_settings.payloads_per_second = the_run_feed_json.value("payloads_per_second", the_run_feed_settings.payloads_per_second);
+      the_run_feed_settings.duration = std::chrono::seconds(the_run_feed_json.value("duration_seconds", the_run_feed_settings.duration.count()));
+      the_run_feed_settings.runners = the_run_feed_json.value("runners", the_run_feed_settings.runners);
+      the_run_feed_settings.sm64_share = the_run_feed_json.value("sm64_share", the_run_feed_settings.sm64_share);
+      the_run_feed_settings.recording_path = the_run_feed_json.value("recording_path", the_run_feed_settings.recording_path);
+    }
+  }
 }
 
 std::string const& Settings::GetBotToken() const noexcept {
   return bot_token_;
 }
 
-dpp::snowflake Settings::GetGuildId() const noexcept {
-  return guild_id_;
+Settings::GatewaySettings const& Settings::GetGatewaySettings() const noexcept {
+  return gateway_settings_;
 }
 
-dpp::snowflake Settings::GetChannelId(Channels const channel) const noexcept  {
-  return channels_ids_.at(channel);
+Settings::CacheSettings const& Settings::GetCacheSettings() const noexcept {
+  return cache_settings_;
 }
 
-dpp::snowflake Settings::GetRoleId(Roles const role) const noexcept {
-  return roles_ids_.at(role);
+Settings::LifecycleSettings const& Settings::GetLifecycleSettings() const noexcept {
+  return lifecycle_settings_;
 }
 
-dpp::snowflake Settings::GetUserId(Users const user) const noexcept {
-  return users_ids_.at(user);
+Settings::AdmissionSettings const& Settings::GetAdmissionSettings() const noexcept {
+  return admission_settings_;
 }
 
-std::map<std::string, std::string> const& Settings::GetAwardsReactionsAndCategories() const noexcept {
-  return awards_reactions_and_categories_;
+Settings::ThrottleSettings const& Settings::GetThrottleSettings() const noexcept {
+  return throttle_settings_;
+}
+
+Settings::ClipsSettings const& Settings::GetClipsSettings() const noexcept {
+  return clips_settings_;
+}
+
+Settings::LoggingSettings const& Settings::GetLoggingSettings() const noexcept {
+  return logging_settings_;
+}
+
+std::map<dpp::snowflake, Settings::Guild> const& Settings::GetGuilds() const noexcept {
+  return guilds_;
+}
+
+Settings::Guild const* Settings::FindGuild(dpp::snowflake const guild_id) const noexcept {
+  auto const it_guild = guilds_.find(guild_id);
+  return (guilds_.cend() != it_guild) ? &it_guild->second : nullptr;
+}
+
+std::chrono::minutes Settings::GetStreamingMessageLifetime() const noexcept {
+  return streaming_message_lifetime_;
+}
+
+std::chrono::seconds Settings::GetStreamingEditInterval() const noexcept {
+  return streaming_edit_interval_;
+}
+
+std::vector<Settings::StreamRule> const& Settings::GetStreamRules() const noexcept {
+  return stream_rules_;
+}
+
+Settings::UpdatesSettings const& Settings::GetUpdatesSettings() const noexcept {
+  return updates_settings_;
 }
 
 std::string const& Settings::GetTheRunEndpoint() const noexcept {
@@ -151,4 +362,8 @@ std::string const& Settings::GetTheRunEndpoint() const noexcept {
 
 Settings::TheRunThresholds const& Settings::GetTheRunThresholds(Categories const category) const noexcept {
   return the_run_thresholds_.at(category);
+}
+
+Settings::HarnessSettings const& Settings::GetHarnessSettings() const noexcept {
+  return harness_settings_;
 }
\ No newline at end of file
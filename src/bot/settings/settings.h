@@ -1,9 +1,14 @@
 #pragma once
 
+#include <chrono>
+#include <cstddef>
+#include <cstdint>
 #include <map>
 #include <string>
+#include <vector>
 
 #include <dpp/dpp.h>
+#include <nlohmann/json_fwd.hpp>
 
 class Settings final {
 public:
@@ -36,24 +41,149 @@ public:
     k120Star
   };
 
+  enum class LogOverflow {
+    kBlock,
+    kDropOldest,
+    kDropNew
+  };
+
   struct TheRunThresholds {
     long long bpt{};
     double percentage{};
   };
 
+  struct StreamRule {
+    std::string platform;
+    std::vector<std::string> games;
+    std::vector<std::string> keywords;
+    std::vector<std::string> exclusions;
+  };
+
+  class Guild final {
+  public:
+    dpp::snowflake GetGuildId() const noexcept;
+    dpp::snowflake GetChannelId(Channels const channel) const noexcept;
+    dpp::snowflake GetRoleId(Roles const role) const noexcept;
+    dpp::snowflake GetUserId(Users const user) const noexcept;
+    std::map<std::string, std::string> const& GetAwardsReactionsAndCategories() const noexcept;
+
+  private:
+    friend class Settings;
+
+    dpp::snowflake guild_id_;
+    std::map<Channels, dpp::snowflake> channels_ids_;
+    std::map<Roles, dpp::snowflake> roles_ids_;
+    std::map<Users, dpp::snowflake> users_ids_;
+    std::map<std::string, std::string> awards_reactions_and_categories_;
+  };
+
+  struct GatewayHealthSettings {
+    std::chrono::milliseconds check_interval = std::chrono::seconds(1);
+    std::chrono::milliseconds ack_timeout = std::chrono::seconds(5);
+    std::chrono::milliseconds event_gap = std::chrono::seconds(90);
+    std::chrono::milliseconds resume_timeout = std::chrono::seconds(10);
+    std::chrono::milliseconds reconnect_timeout = std::chrono::seconds(30);
+  };
+
+  struct GatewaySettings {
+    uint32_t shards{};
+    bool minimal_intents{};
+    bool etf{};
+    bool compression = true;
+    std::chrono::seconds usage_report_interval = std::chrono::minutes(5);
+    GatewayHealthSettings health;
+  };
+
+  struct LifecycleSettings {
+    std::chrono::seconds drain_deadline = std::chrono::seconds(10);
+    std::string state_path = "settings/state.json";
+    std::string dm_channels_path = "settings/dm_channels.jsonl";
+    std::string leader_lock_path = "settings/leader.lock";
+    std::string streams_path = "settings/streams.jsonl";
+    std::chrono::milliseconds standby_poll_interval = std::chrono::milliseconds(250);
+  };
+
+  struct AdmissionSettings {
+    std::size_t command_concurrency = 8;
+    std::size_t message_concurrency = 32;
+    std::size_t presence_concurrency = 16;
+    std::size_t presence_queue_limit = 256;
+  };
+
+  struct ThrottleRate {
+    double per_minute{};
+    double burst{};
+  };
+
+  struct ThrottleSettings {
+    ThrottleRate streaming_messages{.per_minute = 3.0, .burst = 3.0};
+    ThrottleRate clip_links{.per_minute = 10.0, .burst = 10.0};
+    ThrottleRate reactions{.per_minute = 30.0, .burst = 10.0};
+  };
+
+  struct ClipsSettings {
+    std::string index_path = "settings/clips.index";
+    std::size_t initial_capacity = 4096;
+    std::string tally_path = "settings/awards_tally.jsonl";
+  };
+
+  struct CacheSettings {
+    dpp::cache_policy_t dpp_policy;
+    std::size_t user_budget_bytes{};
+    std::chrono::seconds trim_interval = std::chrono::seconds(60);
+  };
+
+  struct UpdatesSettings {
+    std::size_t burst_threshold = 5;
+    std::chrono::seconds burst_window = std::chrono::seconds(10);
+  };
+
+  struct LoggingSettings {
+    std::size_t queue_size = 8192;
+    LogOverflow overflow = LogOverflow::kDropOldest;
+    std::chrono::seconds repeat_window = std::chrono::seconds(30);
+    bool compress_rotated = true;
+  };
+
+  struct TheRunFeedSettings {
+    uint16_t port = 8765;
+    double payloads_per_second = 200.0;
+    std::chrono::seconds duration = std::chrono::seconds(10);
+    std::size_t runners = 50;
+    double sm64_share = 0.5;
+    std::string recording_path;
+  };
+
+  struct HarnessSettings {
+    std::chrono::milliseconds rest_latency{};
+    std::size_t rate_limit_requests{};
+    std::chrono::milliseconds rate_limit_window{};
+    TheRunFeedSettings the_run_feed;
+  };
+
   static Settings& Get() noexcept;
 
   std::string const& GetBotToken() const noexcept;
-
-  dpp::snowflake GetGuildId() const noexcept;
-  dpp::snowflake GetChannelId(Channels const channel) const noexcept;
-  dpp::snowflake GetRoleId(Roles const role) const noexcept;
-  dpp::snowflake GetUserId(Users const user) const noexcept;
-  std::map<std::string, std::string> const& GetAwardsReactionsAndCategories() const noexcept;
+  GatewaySettings const& GetGatewaySettings() const noexcept;
+  CacheSettings const& GetCacheSettings() const noexcept;
+  LifecycleSettings const& GetLifecycleSettings() const noexcept;
+  AdmissionSettings const& GetAdmissionSettings() const noexcept;
+  ThrottleSettings const& GetThrottleSettings() const noexcept;
+  ClipsSettings const& GetClipsSettings() const noexcept;
+  LoggingSettings const& GetLoggingSettings() const noexcept;
+
+  std::map<dpp::snowflake, Guild> const& GetGuilds() const noexcept;
+  Guild const* FindGuild(dpp::snowflake guild_id) const noexcept;
+  std::chrono::minutes GetStreamingMessageLifetime() const noexcept;
+  std::chrono::seconds GetStreamingEditInterval() const noexcept;
+  std::vector<StreamRule> const& GetStreamRules() const noexcept;
+  UpdatesSettings const& GetUpdatesSettings() const noexcept;
 
   std::string const& GetTheRunEndpoint() const noexcept;
   TheRunThresholds const& GetTheRunThresholds(Categories const category) const noexcept;
 
+  HarnessSettings const& GetHarnessSettings() const noexcept;
+
 private:
   Settings();
   ~Settings() = default;
@@ -61,15 +191,30 @@ private:
   Settings(Settings const&) = delete;
   void operator=(Settings const&) = delete;
 
+  static Guild ParseGuild(nlohmann::json const& guild_json, nlohmann::json const& users_json, nlohmann::json const& awards_json);
+
 private:
   std::string bot_token_;
+  GatewaySettings gateway_settings_;
+  CacheSettings cache_settings_;
+  LifecycleSettings lifecycle_settings_;
+  AdmissionSettings admission_settings_;
+  ThrottleSettings throttle_settings_;
+  ClipsSettings clips_settings_;
+  LoggingSettings logging_settings_;
+
+  std::map<dpp::snowflake, Guild> guilds_;
+  std::chrono::minutes streaming_message_lifetime_ = std::chrono::hours(6);
+  std::chrono::seconds streaming_edit_interval_ = std::chrono::seconds(15);
+  std::vector<StreamRule> stream_rules_ = {
+    StreamRule{.platform = "Twitch", .games = {"Super Mario 64"}},
+    StreamRule{.platform = "YouTube", .keywords = {"Mario 64", "SM64"}}
+  };
 
-  dpp::snowflake guild_id_;
-  std::map<Channels, dpp::snowflake> channels_ids_;
-  std::map<Roles, dpp::snowflake> roles_ids_;
-  std::map<Users, dpp::snowflake> users_ids_;
-  std::map<std::string, std::string> awards_reactions_and_categories_;
+  UpdatesSettings updates_settings_;
 
   std::string the_run_endpoint_;
   std::map<Categories, TheRunThresholds> the_run_thresholds_;
+
+  HarnessSettings harness_settings_;
 };
\ No newline at end of file
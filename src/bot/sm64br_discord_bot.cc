@@ -1,33 +1,317 @@
 #include "sm64br_discord_bot.h"
 
 #include <algorithm>
+#include <format>
+#include <optional>
 #include <print>
 #include <ranges>
+#include <thread>
+#include <utility>
+#include <vector>
+
+#include <unistd.h>
 
 #include <nlohmann/json.hpp>
 
-Sm64brDiscordBot::Sm64brDiscordBot() {
-  bot_->on_log([this](dpp::log_t const& event) { OnLog(event); });
-  bot_->on_ready([this](dpp::ready_t const& ready) { OnReady(ready); });
-  bot_->on_message_create([this](dpp::message_create_t const& message_create) { OnMessageCreate(message_create); });
-  bot_->on_message_reaction_add([this](dpp::message_reaction_add_t const& message_reaction_add) { OnMessageReactionAdd(message_reaction_add); });
-  bot_->on_presence_update([this](dpp::presence_update_t const& presence_update) { OnPresenceUpdate(presence_update); });
-  bot_->on_guild_member_add([this](dpp::guild_member_add_t const& guild_member_add) { OnGuildMemberAdd(guild_member_add); });
-  bot_->on_guild_member_remove([this](dpp::guild_member_remove_t const& guild_member_remove) { OnGuildMemberRemove(guild_member_remove); });
+#include "harness/trace_reader.h"
+#include "metrics/allocation_counter.h"
+#include "metrics/resource_usage.h"
+#include "rest/cluster_rest.h"
+
+namespace {
+  // Snowflakes carry their creation time as milliseconds since the Discord epoch in the upper 42 bits,
+  // so every message created after `time` has a larger id than the one returned here.
+  dpp::snowflake SnowflakeAt(std::chrono::system_clock::time_point const time) noexcept {
+    auto constexpr kDiscordEpoch = std::chrono::milliseconds(1420070400000);
+    auto const since_discord_epoch = std::chrono::duration_cast<std::chrono::milliseconds>(time.time_since_epoch()) - kDiscordEpoch;
+    return dpp::snowflake(static_cast<uint64_t>(since_discord_epoch.count()) << 22);
+  }
+
+  std::filesystem::path CreateStandInStateDirectory() {
+    auto const state_directory = std::filesystem::temp_directory_path() / std::format("sm64br_stand_in_{}", getpid());
+    std::filesystem::remove_all(state_directory);
+    std::filesystem::create_directories(state_directory);
+    return state_directory;
+  }
+
+  // Stores a user seen in a replayed event the way the gateway does, so a replay fills DPP's user
+  // cache as the live bot would.
+  void CacheReplayedUser(nlohmann::json* const user_json) {
+    if (!user_json->is_object() || (dpp::cp_none == Settings::Get().GetCacheSettings().dpp_policy.user_policy)) {
+      return;
+    }
+
+    auto user = std::make_unique<dpp::user>();
+    user->fill_from_json(user_json);
+    if (!user->id.empty() && (nullptr == dpp::find_user(user->id))) {
+      dpp::get_user_cache()->store(user.release());
+    }
+  }
+}
+
+Sm64brDiscordBot::Sm64brDiscordBot() :
+  Sm64brDiscordBot(nullptr) {
+
+}
+
+Sm64brDiscordBot::Sm64brDiscordBot(std::shared_ptr<Rest> rest) :
+  state_directory_(rest ? ::CreateStandInStateDirectory() : std::filesystem::path()),
+  rest_(rest ? std::move(rest) : std::make_shared<ClusterRest>(bot_)) {
+  Subscribe(bot_->on_log, 0, [this](dpp::log_t const& event) { OnLog(event); });
+  Subscribe(bot_->on_ready, 0, [this](dpp::ready_t const& ready) { OnReady(ready); });
+  Subscribe(bot_->on_message_create, dpp::i_guild_messages | dpp::i_message_content, [this](dpp::message_create_t const& message_create) { OnMessageCreate(message_create); });
+  Subscribe(bot_->on_message_reaction_add, dpp::i_direct_message_reactions, [this](dpp::message_reaction_add_t const& message_reaction_add) { OnMessageReactionAdd(message_reaction_add); });
+  Subscribe(bot_->on_presence_update, dpp::i_guild_presences, [this](dpp::presence_update_t const& presence_update) { OnPresenceUpdate(presence_update); });
+  Subscribe(bot_->on_slashcommand, 0, [this](dpp::slashcommand_t const& slash_command) { OnSlashCommand(slash_command); });
+  Subscribe(bot_->on_guild_member_add, dpp::i_guild_members, [this](dpp::guild_member_add_t const& guild_member_add) { OnGuildMemberAdd(guild_member_add); });
+  Subscribe(bot_->on_guild_member_remove, dpp::i_guild_members, [this](dpp::guild_member_remove_t const& guild_member_remove) { OnGuildMemberRemove(guild_member_remove); });
+
+  auto const& gateway_settings = Settings::Get().GetGatewaySettings();
+  if (gateway_settings.minimal_intents) {
+    bot_->intents = required_intents_;
+  }
+  if (gateway_settings.etf) {
+    bot_->set_websocket_protocol(dpp::ws_etf);
+  }
+  logger_.Info("Gateway intents 0x{:x}, {} encoding, compression {}", bot_->intents, gateway_settings.etf ? "ETF" : "JSON", gateway_settings.compression ? "on" : "off");
 
-  ClearStreamingRoles();
-  ClearStreamingMessages();
+  std::ranges::for_each(Settings::Get().GetGuilds(), [this](auto const& guild_id_and_guild) { guild_states_.try_emplace(guild_id_and_guild.first); });
 
+  if (!state_directory_.empty()) {
+    logger_.Info("Keeping state in '{}' while running against the REST stand-in", state_directory_.string());
+  }
   logger_.Info("Initialized bot");
 }
 
 Sm64brDiscordBot::~Sm64brDiscordBot() {
+  // The announcer waits on REST calls from its own thread, so it is stopped while they can still
+  // complete. A replay never calls Shutdown, so this is where its bursts are posted.
+  member_announcer_.Stop(std::chrono::steady_clock::now() + Settings::Get().GetLifecycleSettings().drain_deadline);
+
+  // Handlers abandoned at the drain deadline still await REST calls and reference this object, so
+  // their completions are stopped before any member is destroyed. Their frames are leaked instead.
+  rest_->Close();
+
+  if (!state_directory_.empty()) {
+    std::error_code error_code;
+    std::filesystem::remove_all(state_directory_, error_code);
+  }
   logger_.Info("Bot terminated");
 }
 
-void Sm64brDiscordBot::Start() const noexcept {
+bool Sm64brDiscordBot::Start() noexcept {
+  start_time_ = std::chrono::steady_clock::now();
+  stopped_future_ = stopped_.get_future();
+
+  // A signal can start Shutdown at any point of startup. Each startup step runs under the lifecycle
+  // mutex and is skipped once shutdown has begun, so Shutdown never sees a step half done and nothing
+  // is started after it closed the gateway.
+  std::unique_lock<std::mutex> lifecycle_lock(lifecycle_mutex_);
+  auto const wait_stopped = [this, &lifecycle_lock]() {
+    if (lifecycle_lock.owns_lock()) {
+      lifecycle_lock.unlock();
+    }
+    stopped_future_.wait();
+    return true;
+  };
+  if (shutting_down_) {
+    return wait_stopped();
+  }
+
+  // Only the instance holding the leader lock handles events. Any other one connects to the gateway
+  // anyway, keeping its member cache warm, and stands by until the leader's lock is released.
+  auto const standby = !leader_lease_.TryAcquire();
+  if (standby) {
+    standing_by_ = true;
+    accepting_events_ = false;
+    logger_.Info("Another instance holds leader lock '{}', standing by", GetStatePath(Settings::Get().GetLifecycleSettings().leader_lock_path));
+  } else {
+    // A cold start sweeps away every stream the previous run announced, so none is adopted.
+    streaming_log_.Open({});
+  }
+
   logger_.Info("Starting bot event handler loop");
-  bot_->start(dpp::st_wait);
+  try {
+    bot_->start(dpp::st_return);
+  } catch (dpp::exception const& exception) {
+    logger_.Critical("Failed to start bot event handler loop. Error '{}'", exception.what());
+    return false;
+  }
+
+  std::vector<StreamingLog::Stream> adopted_streams;
+  if (standby) {
+    lifecycle_lock.unlock();
+    if (!leader_lease_.Acquire(Settings::Get().GetLifecycleSettings().standby_poll_interval)) {
+      return wait_stopped();
+    }
+
+    lifecycle_lock.lock();
+    if (shutting_down_) {
+      return wait_stopped();
+    }
+
+    auto const takeover_start = std::chrono::steady_clock::now();
+    clip_index_->Reload();
+    awards_tally_->CatchUp();
+    dm_channel_cache_->CatchUp();
+    adopted_streams = streaming_log_.Load();
+    streaming_log_.Open(adopted_streams);
+    AdoptStreams(adopted_streams);
+    {
+      // Presences seen while standing by are handled before any live one, so the latest wins.
+      std::scoped_lock<std::mutex> const standby_presences_lock(standby_presences_mutex_);
+      for (auto& [guild_user_ids, presence_event] : standby_presences_) {
+        SubmitPresenceEvent(*Settings::Get().FindGuild(guild_user_ids.first), std::move(presence_event), takeover_start);
+      }
+      logger_.Info("Caught up on {} presences seen while standing by", standby_presences_.size());
+      standby_presences_.clear();
+      standing_by_ = false;
+      accepting_events_ = true;
+    }
+    if (ready_) {
+      RegisterSlashCommands();
+    }
+    logger_.Info("Took over as leader in {} ms", std::chrono::duration_cast<std::chrono::milliseconds>(std::chrono::steady_clock::now() - takeover_start).count());
+    start_time_ = takeover_start;
+  }
+
+  auto const pending_deletions = deletion_scheduler_->Load(GetStatePath(Settings::Get().GetLifecycleSettings().state_path));
+  std::set<dpp::snowflake> kept_messages_ids;
+  std::ranges::for_each(pending_deletions, [this, &kept_messages_ids](auto const& pending_deletion) {
+    deletion_scheduler_->Schedule(pending_deletion.message_id, pending_deletion.channel_id, pending_deletion.due);
+    kept_messages_ids.insert(pending_deletion.message_id);
+  });
+  logger_.Info("Restored {} pending message deletions", pending_deletions.size());
+  std::ranges::for_each(adopted_streams, [&kept_messages_ids](auto const& stream) { kept_messages_ids.insert(stream.message_id); });
+
+  // Streaming state left behind by the previous run is swept while the gateway connects, so events
+  // are handled as soon as the shards are ready instead of after a full member scan.
+  reconciled_future_ = reconciled_.get_future();
+  reconciliation_.emplace(Reconcile(std::move(kept_messages_ids)));
+
+  auto const& the_run_endpoint = Settings::Get().GetTheRunEndpoint();
+  if (!the_run_endpoint.empty()) {
+    the_run_ = std::make_unique<TheRun>(rest_, the_run_endpoint);
+  }
+
+  auto const usage_report_interval = Settings::Get().GetGatewaySettings().usage_report_interval;
+  if (0 != usage_report_interval.count()) {
+    bot_->start_timer([this](dpp::timer const) {
+      ReportGatewayUsage();
+      gateway_monitor_.Report();
+      ReportCacheUsage();
+      ReportAdmissionUsage();
+      if (!reconciliation_progress_.finished) {
+        ReportReconciliation();
+      }
+    },  static_cast<uint64_t>(usage_report_interval.count()));
+  }
+
+  auto const& cache_settings = Settings::Get().GetCacheSettings();
+  if ((0 != cache_settings.user_budget_bytes) && (0 != cache_settings.trim_interval.count())) {
+    bot_->start_timer([this](dpp::timer const) {
+      TrimUserCache();
+    }, static_cast<uint64_t>(cache_settings.trim_interval.count()));
+  }
+
+  return wait_stopped();
+}
+
+bool Sm64brDiscordBot::Shutdown() noexcept {
+  auto const shutdown_start = std::chrono::steady_clock::now();
+  auto phase_start = shutdown_start;
+  auto const end_phase = [this, &phase_start](std::string_view const phase) {
+    auto const now = std::chrono::steady_clock::now();
+    logger_.Info("Shutdown phase '{}' took {} ms", phase, std::chrono::duration_cast<std::chrono::milliseconds>(now - phase_start).count());
+    phase_start = now;
+  };
+
+  logger_.Info("Shutting down");
+  {
+    // Waits for a startup step in progress, so everything Start set up is seen below.
+    std::scoped_lock<std::mutex> const lifecycle_lock(lifecycle_mutex_);
+    shutting_down_ = true;
+    accepting_events_ = false;
+    leader_lease_.Cancel();
+    admission_controller_.Close();
+  }
+  end_phase("stop accepting events");
+
+  auto const drain_deadline = shutdown_start + Settings::Get().GetLifecycleSettings().drain_deadline;
+  auto abandoned_work = admission_controller_.Drain(drain_deadline);
+  end_phase("drain handlers");
+
+  if (reconciled_future_.valid() && (std::future_status::ready != reconciled_future_.wait_until(drain_deadline))) {
+    logger_.Warn("Startup reconciliation did not stop before the drain deadline");
+    ++abandoned_work;
+  }
+  end_phase("stop reconciliation");
+
+  auto const state_path = GetStatePath(Settings::Get().GetLifecycleSettings().state_path);
+  auto const pending_deletions = deletion_scheduler_->Stop();
+  if (leader_lease_.IsHeld()) {
+    deletion_scheduler_->Save(state_path, pending_deletions);
+    logger_.Info("Saved {} pending message deletions to '{}'", pending_deletions.size(), state_path);
+  }
+  leader_lease_.Release();
+  end_phase("save state");
+
+  member_announcer_.Stop(drain_deadline);
+  end_phase("flush member announcements");
+
+  the_run_.reset();
+  gateway_monitor_.Stop();
+  bot_->shutdown();
+  end_phase("close gateway");
+
+  logger_.Info("Shutdown took {} ms", std::chrono::duration_cast<std::chrono::milliseconds>(std::chrono::steady_clock::now() - shutdown_start).count());
+  stopped_.set_value();
+  return 0 == abandoned_work;
+}
+
+void Sm64brDiscordBot::Record(std::string const& trace_path) {
+  trace_recorder_ = std::make_unique<TraceRecorder>(trace_path);
+}
+
+void Sm64brDiscordBot::Replay(std::string const& trace_path, double const speed) {
+  auto constexpr kMinReplaySpeed = 1.0;
+  auto constexpr kMaxReplaySpeed = 100.0;
+  auto const replay_speed = std::clamp(speed, kMinReplaySpeed, kMaxReplaySpeed);
+
+  TraceReader trace_reader(trace_path);
+  logger_.Info("Replaying gateway events from '{}' at {}x speed", trace_path, replay_speed);
+
+  handler_latency_.Reset();
+
+  std::size_t replayed_events{};
+  auto const replay_start_allocations = AllocationCounter::GetProcess();
+  auto const replay_start_usage = ResourceUsage::Sample();
+  auto const replay_start = std::chrono::steady_clock::now();
+  while (auto const event = trace_reader.Next()) {
+    std::this_thread::sleep_until(replay_start + std::chrono::duration_cast<std::chrono::nanoseconds>(event->offset / replay_speed));
+    DispatchTraceEvent(*event);
+    ++replayed_events;
+  }
+
+  WaitForPendingWork();
+  if (!TrimUserCache()) {
+    logger_.Error("DPP's user cache does not fit its budget of {} KiB after the replay, as pinned users alone exceed it", user_cache_budget_->GetBudgetBytes() / 1024);
+  }
+
+  auto const replay_usage = ResourceUsage::Sample();
+  logger_.Info("Replay used {:.3f} s of CPU, RSS {} KiB, peak RSS {} KiB",
+               std::chrono::duration<double>(replay_usage.cpu_time - replay_start_usage.cpu_time).count(), replay_usage.resident_bytes / 1024, replay_usage.peak_resident_bytes / 1024);
+  ReportCacheUsage();
+  ReportAdmissionUsage();
+  if (AllocationCounter::IsEnabled() && (0 != replayed_events)) {
+    logger_.Info("Replay made {:.1f} heap allocations per event, handlers and DPP included",
+                 static_cast<double>(AllocationCounter::GetProcess() - replay_start_allocations) / static_cast<double>(replayed_events));
+  }
+
+  auto const replay_duration = std::chrono::duration<double>(std::chrono::steady_clock::now() - replay_start).count();
+  logger_.Info("Replayed {} events in {:.3f} s ({:.1f} events/s). Handler latency p50 {} us, p99 {} us, max {} us",
+               replayed_events, replay_duration, (replay_duration > 0.0) ? (static_cast<double>(replayed_events) / replay_duration) : 0.0,
+               handler_latency_.GetPercentile(0.50).count(), handler_latency_.GetPercentile(0.99).count(), handler_latency_.GetMax().count());
 }
 
 void Sm64brDiscordBot::OnLog(dpp::log_t const& log) const noexcept {
@@ -63,38 +347,146 @@ void Sm64brDiscordBot::OnLog(dpp::log_t const& log) const noexcept {
 }
 
 void Sm64brDiscordBot::OnMessageCreate(dpp::message_create_t const& message_create) noexcept {
-  message_create_futures_.remove_if([](auto const& future) { return std::future_status::ready == future.wait_for(std::chrono::milliseconds(0)); });
+  if (!accepting_events_) {
+    return;
+  }
 
-  message_create_futures_.push_back(std::async(std::launch::async, [this, message_create]() {
-    message_handler_.Process(message_create.msg);
-  }));
+  RecordEvent(trace::EventType::kMessageCreate, message_create.raw_event);
+  HandleMessageCreate(message_create.msg);
 }
 
 void Sm64brDiscordBot::OnMessageReactionAdd(dpp::message_reaction_add_t const& message_reaction_add) noexcept {
-  message_reaction_futures_.remove_if([](auto const& future) { return std::future_status::ready == future.wait_for(std::chrono::milliseconds(0)); });
-
-  if (message_reaction_add.message_author_id != bot_->me.id) {
+  if (!accepting_events_) {
     return;
   }
 
-  auto const& message_id = message_reaction_add.message_id;
-  auto const& channel_id = message_reaction_add.channel_id;
+  RecordEvent(trace::EventType::kMessageReactionAdd, message_reaction_add.raw_event);
+  HandleMessageReactionAdd(message_reaction_add.message_id, message_reaction_add.channel_id, message_reaction_add.message_author_id, message_reaction_add.reacting_user.id);
+}
 
-  try {
-    auto const raw_event_json = nlohmann::json::parse(message_reaction_add.raw_event);
-    if (message_reaction_add.reacting_user.id == bot_->me.id) {
-      return;
+void Sm64brDiscordBot::OnPresenceUpdate(dpp::presence_update_t const& presence_update) noexcept {
+  if (!accepting_events_) {
+    if (standing_by_) {
+      TrackStandbyPresence(presence_update.rich_presence);
     }
-  } catch (nlohmann::json::exception const& json_exception) {
-    logger_.Error("Failed to get user id from nomination message '{}' in channel '{}'. Exception: '{}'", message_id.str(), channel_id.str(), json_exception.what());
     return;
   }
-  
-  message_reaction_futures_.push_back(std::async(std::launch::async, [this, message_id, channel_id]() {
-    auto const nomination_message_confirmation = bot_->co_message_get(message_id, channel_id).sync_wait();
+
+  RecordEvent(trace::EventType::kPresenceUpdate, presence_update.raw_event);
+  HandlePresenceUpdate(presence_update.rich_presence);
+}
+
+void Sm64brDiscordBot::OnSlashCommand(dpp::slashcommand_t const& slash_command) noexcept {
+  if (!accepting_events_) {
+    return;
+  }
+
+  if (!message_handler_.IsPermitted(slash_command)) {
+    slash_command.reply(dpp::message("Você não tem permissão para usar esse comando.").set_flags(dpp::m_ephemeral));
+    return;
+  }
+
+  slash_command.thinking(true);
+
+  auto const* guild = Settings::Get().FindGuild(slash_command.command.guild_id);
+  auto const& roles = slash_command.command.member.get_roles();
+  if ((nullptr != guild) && std::ranges::contains(roles, guild->GetRoleId(Settings::Roles::kModerator))) {
+    user_cache_budget_->Pin(slash_command.command.usr.id);
+  } else {
+    user_cache_budget_->Touch(slash_command.command.usr.id);
+  }
+
+  auto const dispatch_time = std::chrono::steady_clock::now();
+  admission_controller_.Submit(AdmissionController::EventClass::kCommand, [this, slash_command, dispatch_time]() -> dpp::task<void> {
+    LatencyHistogram::Scope const latency_scope(handler_latency_, dispatch_time);
+    RecordFirstHandledEvent();
+    co_await message_handler_.Process(slash_command);
+  });
+}
+
+void Sm64brDiscordBot::OnGuildMemberAdd(dpp::guild_member_add_t const& guild_member_add) const noexcept {
+  if (!accepting_events_) {
+    return;
+  }
+
+  RecordEvent(trace::EventType::kGuildMemberAdd, guild_member_add.raw_event);
+  HandleGuildMemberAdd(guild_member_add.added.guild_id, guild_member_add.added.user_id);
+}
+
+void Sm64brDiscordBot::OnGuildMemberRemove(dpp::guild_member_remove_t const& guild_member_remove) const noexcept {
+  if (!accepting_events_) {
+    return;
+  }
+
+  RecordEvent(trace::EventType::kGuildMemberRemove, guild_member_remove.raw_event);
+  HandleGuildMemberRemove(guild_member_remove.guild_id, guild_member_remove.removed.id);
+}
+
+void Sm64brDiscordBot::OnReady(dpp::ready_t const& ready) const noexcept {
+  RecordEvent(trace::EventType::kReady, bot_->me.id.str());
+  user_cache_budget_->Pin(bot_->me.id);
+
+  // A standby registers the commands once it takes over, in case it runs a newer build.
+  ready_ = true;
+  if (!standing_by_) {
+    RegisterSlashCommands();
+  }
+
+  logger_.Info("Bot event handler loop started");
+}
+
+void Sm64brDiscordBot::RegisterSlashCommands() const noexcept {
+  std::call_once(slash_commands_registered_, [this]() {
+    auto const slash_commands = message_handler_.GetSlashCommands(bot_->me.id);
+    std::ranges::for_each(Settings::Get().GetGuilds(), [this, &slash_commands](auto const& guild_id_and_guild) {
+      auto const guild_id = guild_id_and_guild.first;
+      bot_->guild_bulk_command_create(slash_commands, guild_id, [this, guild_id](dpp::confirmation_callback_t const& confirmation) {
+        if (confirmation.is_error()) {
+          logger_.Error("Failed to register slash commands in guild '{}'. Error '{}'", guild_id.str(), confirmation.get_error().human_readable);
+        }
+      });
+    });
+  });
+}
+
+void Sm64brDiscordBot::HandleMessageCreate(dpp::message const& message) noexcept {
+  user_cache_budget_->Touch(message.author.id);
+  if (!message_handler_.IsRoutable(message)) {
+    return;
+  }
+
+  auto const dispatch_time = std::chrono::steady_clock::now();
+  admission_controller_.Submit(AdmissionController::EventClass::kMessage, [this, message_event = MessageEvent::FromMessage(message), dispatch_time]() -> dpp::task<void> {
+    LatencyHistogram::Scope const latency_scope(handler_latency_, dispatch_time);
+    RecordFirstHandledEvent();
+    co_await message_handler_.Process(message_event);
+  });
+}
+
+void Sm64brDiscordBot::HandleMessageReactionAdd(dpp::snowflake const message_id, dpp::snowflake const channel_id, dpp::snowflake const message_author_id, dpp::snowflake const reacting_user_id) noexcept {
+  if (message_author_id != bot_->me.id) {
+    return;
+  }
+
+  if (reacting_user_id == bot_->me.id) {
+    return;
+  }
+
+  user_cache_budget_->Touch(reacting_user_id);
+
+  if (!user_throttle_->TryAcquire(UserThrottle::Action::kReaction, reacting_user_id)) {
+    return;
+  }
+
+  auto const dispatch_time = std::chrono::steady_clock::now();
+  admission_controller_.Submit(AdmissionController::EventClass::kMessage, [this, message_id, channel_id, reacting_user_id, dispatch_time]() -> dpp::task<void> {
+    LatencyHistogram::Scope const latency_scope(handler_latency_, dispatch_time);
+    RecordFirstHandledEvent();
+
+    auto const nomination_message_confirmation = co_await rest_->CoMessageGet(message_id, channel_id);
     if (nomination_message_confirmation.is_error()) {
       logger_.Error("Failed to get nomination message '{}' in channel '{}'.Error: '{}'", message_id.str(), channel_id.str(), nomination_message_confirmation.get_error().human_readable);
-      return;
+      co_return;
     }
 
     auto const nomination_message = nomination_message_confirmation.get<dpp::message>();
@@ -104,143 +496,536 @@ void Sm64brDiscordBot::OnMessageReactionAdd(dpp::message_reaction_add_t const& m
     });
 
     if (user_reaction == reactions.end()) {
-      return;
+      co_return;
     }
 
     auto const& content = nomination_message.content;
-    auto const awards_reactions_and_categories = Settings::Get().GetAwardsReactionsAndCategories();
-    if (!awards_reactions_and_categories.contains(user_reaction->emoji_name)) {
+    auto const* guild = Settings::Get().FindGuild(message_handler_.FindNominationGuildId(message_id));
+    if (nullptr == guild) {
+      auto const& guilds = Settings::Get().GetGuilds();
+      auto const it_guild = std::ranges::find_if(guilds, [&user_reaction](auto const& guild_id_and_guild) {
+        return guild_id_and_guild.second.GetAwardsReactionsAndCategories().contains(user_reaction->emoji_name);
+      });
+      guild = (guilds.cend() != it_guild) ? &it_guild->second : nullptr;
+    }
+
+    if ((nullptr == guild) || !guild->GetAwardsReactionsAndCategories().contains(user_reaction->emoji_name)) {
       logger_.Error("Received an invalid awards reaction '{}' in message '{}'", user_reaction->emoji_name, content);
-      return;
+      co_return;
     }
-    auto const nominated_category = awards_reactions_and_categories.at(user_reaction->emoji_name);
+    auto const& nominated_category = guild->GetAwardsReactionsAndCategories().at(user_reaction->emoji_name);
 
     auto const clip_url = content.substr(content.rfind('\n') + 1);
     if (clip_url.empty()) {
       logger_.Error("Received an invalid awards message '{}' without a video", content);
-      return;
+      co_return;
+    }
+
+    if (!awards_tally_->Record(guild->GetGuildId(), reacting_user_id, nominated_category, clip_url)) {
+      logger_.Info("User '{}' already nominated clip '{}'", reacting_user_id.str(), clip_url);
+      co_return;
     }
 
-    auto const petalite_user_id = Settings::Get().GetUserId(Settings::Users::kPetalite);
-    auto const petalite_content = std::format("Clipe: {}\nCategoria: {}", clip_url, nominated_category);
-    bot_->direct_message_create(petalite_user_id, dpp::message(petalite_content));
-  }));
+    auto const petalite_user_id = guild->GetUserId(Settings::Users::kPetalite);
+    dpp::message petalite_message;
+    petalite_message.content = std::format("Clipe: {}\nCategoria: {}", clip_url, nominated_category);
+    direct_messenger_->Send(petalite_user_id, petalite_message);
+  });
 }
 
-void Sm64brDiscordBot::OnPresenceUpdate(dpp::presence_update_t const& presence_update) noexcept {
-  presence_update_futures_.remove_if([](auto const& future) { return std::future_status::ready == future.wait_for(std::chrono::milliseconds(0)); });
-
-  presence_update_futures_.push_back(std::async(std::launch::async, [this, presence_update]() {
-    auto const& activies = presence_update.rich_presence.activities;
-    auto const streaming_activity = std::ranges::find_if(activies, [](auto const& activity) {
-      auto const is_streaming = activity.type == dpp::activity_type::at_streaming;
-      auto const is_streaming_sm64_in_twitch = (activity.name == "Twitch") && (activity.state == "Super Mario 64");
-      auto const is_streaming_sm64_in_youtube = (activity.name == "YouTube") && (activity.details.contains("Mario 64") || activity.details.contains("SM64"));
-      return is_streaming && (is_streaming_sm64_in_twitch || is_streaming_sm64_in_youtube);
-    });
-    auto const is_streaming_sm64 = activies.cend() != streaming_activity;
+void Sm64brDiscordBot::HandlePresenceUpdate(dpp::presence const& presence) noexcept {
+  user_cache_budget_->Touch(presence.user_id);
+  auto const* guild = Settings::Get().FindGuild(presence.guild_id);
+  if (nullptr == guild) {
+    return;
+  }
+
+  SubmitPresenceEvent(*guild, PresenceEvent::FromPresence(presence, stream_matcher_), std::chrono::steady_clock::now());
+}
 
-    auto const& streaming_user_id = presence_update.rich_presence.user_id;
+void Sm64brDiscordBot::SubmitPresenceEvent(Settings::Guild const& guild, PresenceEvent presence_event, std::chrono::steady_clock::time_point const dispatch_time) noexcept {
+  auto const presence_key = AdmissionController::Key{presence_event.guild_id, presence_event.user_id};
+  admission_controller_.Submit(AdmissionController::EventClass::kPresence, presence_key,
+                               [this, &guild, presence_event = std::move(presence_event), dispatch_time]() -> dpp::task<void> {
+    LatencyHistogram::Scope const latency_scope(handler_latency_, dispatch_time);
+    RecordFirstHandledEvent();
 
-    std::scoped_lock<std::mutex> const mutex_lock(on_presence_update_mutex_);
+    auto const& streaming_user_id = presence_event.user_id;
+    auto& guild_state = guild_states_.at(guild.GetGuildId());
+    auto& streaming_users_ids_and_states = guild_state.streaming_users_ids_and_states;
 
-    auto const it_user_id_and_message_id = streaming_users_ids_and_messages_ids_.find(streaming_user_id);
-    auto const streaming_message_sent_ = (streaming_users_ids_and_messages_ids_.cend() != it_user_id_and_message_id);
-    if (is_streaming_sm64) {
-      if (!streaming_message_sent_) {
-        logger_.Info("User '{}' started streaming Super Mario 64", streaming_user_id.str());
+    std::optional<dpp::message> streaming_message;
+    if (presence_event.stream) {
+      streaming_message.emplace(guild.GetChannelId(Settings::Channels::kStreams), std::string());
+      streaming_message->content = std::format("{} **{}**\n{}", dpp::user::get_mention(streaming_user_id), presence_event.stream->details, presence_event.stream->url);
+    }
+
+    if (!streaming_message) {
+      dpp::snowflake streaming_message_id;
+      {
+        std::scoped_lock<std::mutex> const mutex_lock(guild_state.on_presence_update_mutex);
 
-        auto const streaming_message = dpp::message(Settings::Get().GetChannelId(Settings::Channels::kStreams), std::format("{} **{}**\n{}", dpp::user::get_mention(streaming_user_id), streaming_activity->details, streaming_activity->url));
-        auto const streaming_message_confirmation = bot_->co_message_create(streaming_message).sync_wait();
-        if (streaming_message_confirmation.is_error()) {
-          logger_.Error("Failed to create streaming message for user '{}' while processing presence update. Error '{}'", streaming_user_id.str(), streaming_message_confirmation.get_error().human_readable);
-          return;
+        auto const it_user_id_and_state = streaming_users_ids_and_states.find(streaming_user_id);
+        if (streaming_users_ids_and_states.cend() == it_user_id_and_state) {
+          co_return;
         }
 
-        bot_->guild_member_add_role(Settings::Get().GetGuildId(), streaming_user_id, Settings::Get().GetRoleId(Settings::Roles::kStreaming));
+        if (it_user_id_and_state->second.message_id.empty()) {
+          it_user_id_and_state->second.stop_requested = true;
+          co_return;
+        }
 
-        auto const streaming_message_id = streaming_message_confirmation.get<dpp::message>().id;
-        streaming_users_ids_and_messages_ids_[streaming_user_id] = streaming_message_id;
+        streaming_message_id = it_user_id_and_state->second.message_id;
+        streaming_users_ids_and_states.erase(it_user_id_and_state);
       }
-    } else {
-      if (streaming_message_sent_) {
-        logger_.Info("User '{}' finished streaming Super Mario 64", streaming_user_id.str());
+      streaming_log_.Erase(guild.GetGuildId(), streaming_user_id);
+      user_cache_budget_->Unpin(streaming_user_id);
 
-        bot_->message_delete(it_user_id_and_message_id->second, Settings::Get().GetChannelId(Settings::Channels::kStreams));
-        bot_->guild_member_remove_role(Settings::Get().GetGuildId(), streaming_user_id, Settings::Get().GetRoleId(Settings::Roles::kStreaming));
+      StopStreaming(guild, streaming_user_id, streaming_message_id);
+      co_return;
+    }
 
-        streaming_users_ids_and_messages_ids_.erase(it_user_id_and_message_id);
+    auto const edit_interval = Settings::Get().GetStreamingEditInterval();
+    std::optional<std::chrono::steady_clock::duration> edit_delay;
+    {
+      std::scoped_lock<std::mutex> const mutex_lock(guild_state.on_presence_update_mutex);
+      auto const [it_user_id_and_state, claimed] = streaming_users_ids_and_states.try_emplace(streaming_user_id);
+      if (claimed) {
+        it_user_id_and_state->second.content = streaming_message->content;
+        it_user_id_and_state->second.last_edit = std::chrono::steady_clock::now();
+      } else {
+        edit_delay = it_user_id_and_state->second.RequestEdit(streaming_message->content, edit_interval);
+        if (!edit_delay) {
+          co_return;
+        }
       }
     }
-  }));
+
+    if (edit_delay) {
+      if (edit_delay->count() > 0) {
+        ScheduleStreamingEdit(guild, streaming_user_id, *edit_delay);
+      } else {
+        co_await EditStreamingMessage(guild, streaming_user_id);
+      }
+      co_return;
+    }
+
+    logger_.Info("User '{}' started streaming Super Mario 64", streaming_user_id.str());
+
+    auto const streaming_message_confirmation = co_await rest_->CoMessageCreate(*streaming_message);
+    auto const streaming_message_id = streaming_message_confirmation.is_error() ? dpp::snowflake{} : streaming_message_confirmation.get<dpp::message>().id;
+
+    bool stop_requested{};
+    {
+      std::scoped_lock<std::mutex> const mutex_lock(guild_state.on_presence_update_mutex);
+
+      auto const it_user_id_and_state = streaming_users_ids_and_states.find(streaming_user_id);
+      stop_requested = it_user_id_and_state->second.stop_requested;
+      if (streaming_message_id.empty() || stop_requested) {
+        streaming_users_ids_and_states.erase(it_user_id_and_state);
+      } else {
+        auto& streaming_state = it_user_id_and_state->second;
+        streaming_state.message_id = streaming_message_id;
+        if (streaming_state.pending_content) {
+          edit_delay = streaming_state.RequestEdit(*streaming_state.pending_content, edit_interval);
+        }
+      }
+    }
+
+    if (streaming_message_id.empty()) {
+      logger_.Error("Failed to create streaming message for user '{}' while processing presence update. Error '{}'", streaming_user_id.str(), streaming_message_confirmation.get_error().human_readable);
+      co_return;
+    }
+
+    if (stop_requested) {
+      StopStreaming(guild, streaming_user_id, streaming_message_id);
+      co_return;
+    }
+
+    streaming_log_.Record(StreamingLog::Stream{.guild_id = guild.GetGuildId(), .user_id = streaming_user_id, .message_id = streaming_message_id, .content = streaming_message->content});
+    user_cache_budget_->Pin(streaming_user_id);
+    rest_->GuildMemberAddRole(guild.GetGuildId(), streaming_user_id, guild.GetRoleId(Settings::Roles::kStreaming));
+
+    if (edit_delay) {
+      ScheduleStreamingEdit(guild, streaming_user_id, *edit_delay);
+    }
+  });
 }
 
-void Sm64brDiscordBot::OnGuildMemberAdd(dpp::guild_member_add_t const& guild_member_add) const noexcept {
-  auto const join_message = dpp::message(Settings::Get().GetChannelId(Settings::Channels::kUpdates), std::format("**{}** acabou de entrar no servidor.", guild_member_add.added.get_user()->get_mention()));
-  bot_->message_create(join_message);
+void Sm64brDiscordBot::TrackStandbyPresence(dpp::presence const& presence) noexcept {
+  if (nullptr == Settings::Get().FindGuild(presence.guild_id)) {
+    return;
+  }
+
+  auto presence_event = PresenceEvent::FromPresence(presence, stream_matcher_);
+  {
+    std::scoped_lock<std::mutex> const standby_presences_lock(standby_presences_mutex_);
+    if (standing_by_) {
+      standby_presences_.insert_or_assign(AdmissionController::Key{presence.guild_id, presence.user_id}, std::move(presence_event));
+      return;
+    }
+  }
+
+  // Took over since this update arrived, after catching up on the ones kept so far.
+  HandlePresenceUpdate(presence);
 }
 
-void Sm64brDiscordBot::OnGuildMemberRemove(dpp::guild_member_remove_t const& guild_member_remove) const noexcept {
-  auto const leave_message = dpp::message(Settings::Get().GetChannelId(Settings::Channels::kUpdates), std::format("**{}** acabou de sair no servidor.", guild_member_remove.removed.get_mention()));
-  bot_->message_create(leave_message);
+void Sm64brDiscordBot::AdoptStreams(std::vector<StreamingLog::Stream> const& streams) noexcept {
+  for (auto const& stream : streams) {
+    auto const it_guild_state = guild_states_.find(stream.guild_id);
+    if (guild_states_.end() == it_guild_state) {
+      continue;
+    }
+
+    std::scoped_lock<std::mutex> const mutex_lock(it_guild_state->second.on_presence_update_mutex);
+    auto& streaming_state = it_guild_state->second.streaming_users_ids_and_states[stream.user_id];
+    streaming_state.message_id = stream.message_id;
+    streaming_state.content = stream.content;
+    user_cache_budget_->Pin(stream.user_id);
+  }
+  logger_.Info("Adopted {} streams announced by the previous leader", streams.size());
 }
 
-void Sm64brDiscordBot::OnReady(dpp::ready_t const& ready) const noexcept {
-  logger_.Info("Bot event handler loop started");
+void Sm64brDiscordBot::StopStreaming(Settings::Guild const& guild, dpp::snowflake const user_id, dpp::snowflake const message_id) const noexcept {
+  logger_.Info("User '{}' finished streaming Super Mario 64", user_id.str());
+
+  rest_->MessageDelete(message_id, guild.GetChannelId(Settings::Channels::kStreams));
+  rest_->GuildMemberRemoveRole(guild.GetGuildId(), user_id, guild.GetRoleId(Settings::Roles::kStreaming));
+}
+
+void Sm64brDiscordBot::ScheduleStreamingEdit(Settings::Guild const& guild, dpp::snowflake const user_id, std::chrono::steady_clock::duration const delay) noexcept {
+  // Delayed by the admission dispatcher rather than a DPP timer, which never fires in a replay.
+  admission_controller_.Submit(AdmissionController::EventClass::kPresence, std::chrono::steady_clock::now() + delay, [this, &guild, user_id]() -> dpp::task<void> {
+    co_await EditStreamingMessage(guild, user_id);
+  }, [this, &guild, user_id]() {
+    // Lets the next title or category change schedule the edit again.
+    auto& guild_state = guild_states_.at(guild.GetGuildId());
+    std::scoped_lock<std::mutex> const mutex_lock(guild_state.on_presence_update_mutex);
+    auto const it_user_id_and_state = guild_state.streaming_users_ids_and_states.find(user_id);
+    if (guild_state.streaming_users_ids_and_states.cend() != it_user_id_and_state) {
+      it_user_id_and_state->second.edit_scheduled = false;
+    }
+  });
+}
+
+dpp::task<void> Sm64brDiscordBot::EditStreamingMessage(Settings::Guild const& guild, dpp::snowflake const user_id) noexcept {
+  auto& guild_state = guild_states_.at(guild.GetGuildId());
+
+  dpp::message streaming_message(guild.GetChannelId(Settings::Channels::kStreams), std::string());
+  std::string posted_content;
+  {
+    std::scoped_lock<std::mutex> const mutex_lock(guild_state.on_presence_update_mutex);
+    auto const it_user_id_and_state = guild_state.streaming_users_ids_and_states.find(user_id);
+    if (guild_state.streaming_users_ids_and_states.cend() == it_user_id_and_state) {
+      co_return;
+    }
+
+    auto& streaming_state = it_user_id_and_state->second;
+    streaming_state.edit_scheduled = false;
+    if (!streaming_state.pending_content || streaming_state.message_id.empty()) {
+      co_return;
+    }
+
+    streaming_message.id = streaming_state.message_id;
+    streaming_message.content = std::move(*streaming_state.pending_content);
+    streaming_state.pending_content.reset();
+    posted_content = std::exchange(streaming_state.content, streaming_message.content);
+    streaming_state.last_edit = std::chrono::steady_clock::now();
+  }
+
+  auto const streaming_message_confirmation = co_await rest_->CoMessageEdit(streaming_message);
+  if (streaming_message_confirmation.is_error()) {
+    logger_.Error("Failed to update streaming message of user '{}'. Error '{}'", user_id.str(), streaming_message_confirmation.get_error().human_readable);
+
+    // The next presence update that differs from what is actually posted tries again.
+    std::scoped_lock<std::mutex> const mutex_lock(guild_state.on_presence_update_mutex);
+    auto const it_user_id_and_state = guild_state.streaming_users_ids_and_states.find(user_id);
+    if ((guild_state.streaming_users_ids_and_states.cend() != it_user_id_and_state) && (it_user_id_and_state->second.message_id == streaming_message.id)) {
+      it_user_id_and_state->second.content = std::move(posted_content);
+    }
+    co_return;
+  }
+
+  streaming_log_.Record(StreamingLog::Stream{.guild_id = guild.GetGuildId(), .user_id = user_id, .message_id = streaming_message.id, .content = streaming_message.content});
+  logger_.Info("Updated streaming message of user '{}'", user_id.str());
+}
+
+void Sm64brDiscordBot::HandleGuildMemberAdd(dpp::snowflake const guild_id, dpp::snowflake const user_id) const noexcept {
+  LatencyHistogram::Scope const latency_scope(handler_latency_, std::chrono::steady_clock::now());
+  RecordFirstHandledEvent();
+
+  user_cache_budget_->Touch(user_id);
+  member_announcer_.AnnounceJoin(guild_id, user_id);
+}
+
+void Sm64brDiscordBot::HandleGuildMemberRemove(dpp::snowflake const guild_id, dpp::snowflake const user_id) const noexcept {
+  LatencyHistogram::Scope const latency_scope(handler_latency_, std::chrono::steady_clock::now());
+  RecordFirstHandledEvent();
+
+  member_announcer_.AnnounceLeave(guild_id, user_id);
+}
+
+void Sm64brDiscordBot::ReportGatewayUsage() const noexcept {
+  uint64_t bytes_in{};
+  uint64_t decompressed_bytes_in{};
+  auto const shards = bot_->get_shards();
+  std::ranges::for_each(shards, [&bytes_in, &decompressed_bytes_in](auto const& shard) {
+    bytes_in += shard.second->get_bytes_in();
+    decompressed_bytes_in += shard.second->get_decompressed_bytes_in();
+  });
+
+  auto const usage = ResourceUsage::Sample();
+  logger_.Info("Gateway received {} KiB ({} KiB decompressed) over {} shards. CPU {:.3f} s, RSS {} KiB, peak RSS {} KiB",
+               bytes_in / 1024, decompressed_bytes_in / 1024, shards.size(), std::chrono::duration<double>(usage.cpu_time).count(), usage.resident_bytes / 1024, usage.peak_resident_bytes / 1024);
+}
+
+void Sm64brDiscordBot::ReportCacheUsage() const noexcept {
+  logger_.Info("DPP caches hold {} users, {} guilds, {} channels, {} roles, {} emojis",
+               dpp::get_user_count(), dpp::get_guild_count(), dpp::get_channel_count(), dpp::get_role_count(), dpp::get_emoji_count());
+
+  auto const clip_index_stats = clip_index_->GetStats();
+  logger_.Info("Clip index holds {} clips in {} slots. {} lookups, {} answered by the Bloom filter, {} duplicates",
+               clip_index_stats.entries, clip_index_stats.capacity, clip_index_stats.lookups, clip_index_stats.bloom_rejections, clip_index_stats.duplicates);
+
+  auto const dm_channel_cache_stats = dm_channel_cache_->GetStats();
+  auto const dm_channel_lookups = dm_channel_cache_stats.hits + dm_channel_cache_stats.misses;
+  logger_.Info("DM channel cache holds {} channels, {} hits, {} misses ({:.1f}% hit rate)", dm_channel_cache_stats.entries, dm_channel_cache_stats.hits, dm_channel_cache_stats.misses,
+               (0 == dm_channel_lookups) ? 0.0 : 100.0 * static_cast<double>(dm_channel_cache_stats.hits) / static_cast<double>(dm_channel_lookups));
+
+  if (0 != user_cache_budget_->GetBudgetBytes()) {
+    auto const user_cache_stats = user_cache_budget_->GetStats();
+    logger_.Info("User cache budget: {} users, {} KiB of {} KiB at the last trim, {} pinned, {} evicted", user_cache_stats.users, user_cache_stats.bytes / 1024,
+                 user_cache_budget_->GetBudgetBytes() / 1024, user_cache_stats.pinned, user_cache_stats.evicted);
+  }
 }
 
-void Sm64brDiscordBot::ClearStreamingRoles() const {
+bool Sm64brDiscordBot::TrimUserCache() const noexcept {
+  if (0 == user_cache_budget_->GetBudgetBytes()) {
+    return true;
+  }
+
+  return user_cache_budget_->Trim().bytes <= user_cache_budget_->GetBudgetBytes();
+}
+
+void Sm64brDiscordBot::ReportAdmissionUsage() const noexcept {
+  for (auto const [event_class, name] : {std::pair{AdmissionController::EventClass::kCommand, "commands"}, std::pair{AdmissionController::EventClass::kMessage, "messages"}, std::pair{AdmissionController::EventClass::kPresence, "presence updates"}}) {
+    auto const stats = admission_controller_.GetStats(event_class);
+    logger_.Info("Admitted {} {}, coalesced {}, shed {}, {} queued, {} in flight", stats.admitted, name, stats.coalesced, stats.shed, stats.queued, stats.in_flight);
+  }
+
+  for (auto const [action, name] : {std::pair{UserThrottle::Action::kStreamingMessage, "streaming message DMs"}, std::pair{UserThrottle::Action::kClipLink, "clip links"}, std::pair{UserThrottle::Action::kReaction, "reactions"}}) {
+    auto const stats = user_throttle_->GetStats(action);
+    logger_.Info("Allowed {} {}, throttled {}", stats.allowed, name, stats.throttled);
+  }
+  logger_.Info("Throttling {} users", user_throttle_->GetUserCount());
+}
+
+void Sm64brDiscordBot::ReportReconciliation() const noexcept {
+  if (!reconciled_future_.valid()) {
+    return;
+  }
+
+  auto const& progress = reconciliation_progress_;
+  logger_.Info("Reconciliation {}: {}/{} guilds, {} members scanned, {} streaming roles cleared, {} of {} scanned messages deleted, {} failures",
+               progress.finished ? "finished" : "running", progress.guilds.load(), Settings::Get().GetGuilds().size(), progress.members_scanned.load(), progress.roles_cleared.load(),
+               progress.messages_deleted.load(), progress.messages_scanned.load(), progress.failures.load());
+}
+
+void Sm64brDiscordBot::RecordFirstHandledEvent() const noexcept {
+  if ((std::chrono::steady_clock::time_point{} == start_time_) || first_event_handled_.exchange(true)) {
+    return;
+  }
+
+  logger_.Info("First event handled {} ms after start{}", std::chrono::duration_cast<std::chrono::milliseconds>(std::chrono::steady_clock::now() - start_time_).count(),
+               reconciliation_progress_.finished ? "" : ", while startup reconciliation was still running");
+}
+
+void Sm64brDiscordBot::RecordEvent(trace::EventType const type, std::string const& raw_event) const noexcept {
+  if (trace_recorder_) {
+    trace_recorder_->Record(type, raw_event);
+  }
+}
+
+void Sm64brDiscordBot::DispatchTraceEvent(trace::Event const& event) noexcept {
+  if (trace::EventType::kReady == event.type) {
+    bot_->me.id = dpp::snowflake(event.payload);
+    user_cache_budget_->Pin(bot_->me.id);
+    return;
+  }
+
+  try {
+    auto event_json = nlohmann::json::parse(event.payload);
+    auto& data = event_json["d"];
+
+    switch (event.type) {
+      case trace::EventType::kMessageCreate: {
+        ::CacheReplayedUser(&data["author"]);
+        dpp::message message(bot_.get());
+        message.fill_from_json(&data);
+        HandleMessageCreate(message);
+        break;
+      }
+      case trace::EventType::kMessageReactionAdd: {
+        auto reacting_user_json = nlohmann::json{{"id", data.value("user_id", std::string())}};
+        ::CacheReplayedUser(&reacting_user_json);
+        HandleMessageReactionAdd(dpp::snowflake_not_null(&data, "message_id"), dpp::snowflake_not_null(&data, "channel_id"), dpp::snowflake_not_null(&data, "message_author_id"), dpp::snowflake_not_null(&data, "user_id"));
+        break;
+      }
+      case trace::EventType::kPresenceUpdate: {
+        ::CacheReplayedUser(&data["user"]);
+        dpp::presence presence;
+        presence.fill_from_json(&data);
+        HandlePresenceUpdate(presence);
+        break;
+      }
+      case trace::EventType::kGuildMemberAdd: {
+        ::CacheReplayedUser(&data["user"]);
+        HandleGuildMemberAdd(dpp::snowflake_not_null(&data, "guild_id"), dpp::snowflake_not_null(&data["user"], "id"));
+        break;
+      }
+      case trace::EventType::kGuildMemberRemove: {
+        HandleGuildMemberRemove(dpp::snowflake_not_null(&data, "guild_id"), dpp::snowflake_not_null(&data["user"], "id"));
+        break;
+      }
+      default: {
+        logger_.Warn("Skipping trace event with unknown type '{}'", static_cast<int>(event.type));
+        break;
+      }
+    }
+  } catch (nlohmann::json::exception const& json_exception) {
+    logger_.Error("Failed to parse trace event of type '{}'. Exception: '{}'", static_cast<int>(event.type), json_exception.what());
+  }
+}
+
+void Sm64brDiscordBot::WaitForPendingWork() noexcept {
+  admission_controller_.WaitIdle();
+}
+
+dpp::task<void> Sm64brDiscordBot::Reconcile(std::set<dpp::snowflake> const kept_messages_ids) noexcept {
+  auto const reconciliation_start = std::chrono::steady_clock::now();
+  auto const cutoff_message_id = ::SnowflakeAt(std::chrono::system_clock::now());
+
+  for (auto const& [guild_id, guild] : Settings::Get().GetGuilds()) {
+    if (!accepting_events_) {
+      break;
+    }
+
+    co_await ClearStreamingRoles(guild);
+    co_await ClearStreamingMessages(guild, kept_messages_ids, cutoff_message_id);
+    ++reconciliation_progress_.guilds;
+    logger_.Info("Reconciled streaming state of guild '{}'", guild_id.str());
+  }
+
+  reconciliation_progress_.finished = true;
+  logger_.Info("Startup reconciliation took {} ms", std::chrono::duration_cast<std::chrono::milliseconds>(std::chrono::steady_clock::now() - reconciliation_start).count());
+  ReportReconciliation();
+  reconciled_.set_value();
+}
+
+dpp::task<void> Sm64brDiscordBot::ClearStreamingRoles(Settings::Guild const& guild) noexcept {
+  auto const streaming_role_id = guild.GetRoleId(Settings::Roles::kStreaming);
   dpp::snowflake highest_member_id{};
-  dpp::guild_member_map members;
-  do {
+  while (accepting_events_) {
     uint16_t constexpr kMaxMembersPerCall = 1000;
-    auto const members_confirmation = bot_->co_guild_get_members(Settings::Get().GetGuildId(), kMaxMembersPerCall, highest_member_id).sync_wait();
+    auto const members_confirmation = co_await rest_->CoGuildGetMembers(guild.GetGuildId(), kMaxMembersPerCall, highest_member_id);
     if (members_confirmation.is_error()) {
       logger_.Error("Failed to get members when clearing streaming roles. Error: '{}'", members_confirmation.get_error().human_readable);
-      throw members_confirmation.get_error();
+      ++reconciliation_progress_.failures;
+      co_return;
+    }
+
+    auto const members = members_confirmation.get<dpp::guild_member_map>();
+    if (members.empty()) {
+      co_return;
     }
 
-    members = members_confirmation.get<dpp::guild_member_map>();
-    std::ranges::for_each(members, [this, &highest_member_id](auto const& member) {
+    std::vector<dpp::snowflake> streaming_members_ids;
+    std::ranges::for_each(members, [this, &guild, &highest_member_id, &streaming_members_ids, streaming_role_id](auto const& member) {
       if (highest_member_id < member.first) {
         highest_member_id = member.first;
       }
 
       auto const& roles = member.second.get_roles();
-      auto const it_streaming_role = std::find(roles.cbegin(), roles.cend(), Settings::Get().GetRoleId(Settings::Roles::kStreaming));
-      if (it_streaming_role != roles.cend()) {
-        auto const member_remove_role_confirmation = bot_->co_guild_member_remove_role(Settings::Get().GetGuildId(), member.second.user_id, Settings::Get().GetRoleId(Settings::Roles::kStreaming)).sync_wait();
-        if (member_remove_role_confirmation.is_error()) {
-          logger_.Error("Failed to remove role from member while clearing streaming roles. Error: '{}'", member_remove_role_confirmation.get_error().human_readable);
-          throw member_remove_role_confirmation.get_error();
-        }
+      // Streams adopted from the previous leader keep their role.
+      if ((roles.cend() != std::find(roles.cbegin(), roles.cend(), streaming_role_id)) && !IsStreaming(guild.GetGuildId(), member.first)) {
+        streaming_members_ids.push_back(member.first);
       }
     });
-  } while (!members.empty());
+    reconciliation_progress_.members_scanned += members.size();
+
+    std::vector<dpp::async<dpp::confirmation_callback_t>> role_removals;
+    std::ranges::transform(streaming_members_ids, std::back_inserter(role_removals), [this, &guild, streaming_role_id](auto const member_id) {
+      return rest_->CoGuildMemberRemoveRole(guild.GetGuildId(), member_id, streaming_role_id);
+    });
+
+    for (std::size_t i = 0; i < role_removals.size(); ++i) {
+      auto const member_remove_role_confirmation = co_await role_removals[i];
+      if (member_remove_role_confirmation.is_error()) {
+        logger_.Error("Failed to remove role from member while clearing streaming roles. Error: '{}'", member_remove_role_confirmation.get_error().human_readable);
+        ++reconciliation_progress_.failures;
+        continue;
+      }
+      ++reconciliation_progress_.roles_cleared;
+
+      // A presence update handled since the gateway connected may have given the role back before
+      // this removal landed, so a member who is streaming now gets it again.
+      if (IsStreaming(guild.GetGuildId(), streaming_members_ids[i])) {
+        rest_->GuildMemberAddRole(guild.GetGuildId(), streaming_members_ids[i], streaming_role_id);
+      }
+    }
+  }
 }
 
-void Sm64brDiscordBot::ClearStreamingMessages() const {
+dpp::task<void> Sm64brDiscordBot::ClearStreamingMessages(Settings::Guild const& guild, std::set<dpp::snowflake> const& kept_messages_ids, dpp::snowflake const cutoff_message_id) noexcept {
+  auto const streams_channel_id = guild.GetChannelId(Settings::Channels::kStreams);
   dpp::snowflake highest_streaming_message_id = 1ULL;
-  dpp::message_map streaming_messages;
-  do {
+  while (accepting_events_ && (highest_streaming_message_id < cutoff_message_id)) {
     auto constexpr kMaxMessagesPerCall = 100ULL;
-    auto const streaming_messages_confirmation = bot_->co_messages_get(Settings::Get().GetChannelId(Settings::Channels::kStreams), {}, {}, highest_streaming_message_id, kMaxMessagesPerCall).sync_wait();
+    auto const streaming_messages_confirmation = co_await rest_->CoMessagesGet(streams_channel_id, {}, {}, highest_streaming_message_id, kMaxMessagesPerCall);
     if (streaming_messages_confirmation.is_error()) {
       logger_.Error("Failed to messages when clearing streaming messages. Error: '{}'", streaming_messages_confirmation.get_error().human_readable);
-      throw streaming_messages_confirmation.get_error();
+      ++reconciliation_progress_.failures;
+      co_return;
     }
 
-    streaming_messages = streaming_messages_confirmation.get<dpp::message_map>();
-    std::ranges::for_each(streaming_messages, [this, &highest_streaming_message_id](auto const& streaming_message) {
+    auto const streaming_messages = streaming_messages_confirmation.get<dpp::message_map>();
+    if (streaming_messages.empty()) {
+      co_return;
+    }
+
+    // Messages posted after the sweep started belong to streams announced by this run.
+    std::vector<dpp::async<dpp::confirmation_callback_t>> message_deletions;
+    std::ranges::for_each(streaming_messages, [this, &kept_messages_ids, &highest_streaming_message_id, &message_deletions, streams_channel_id, cutoff_message_id](auto const& streaming_message) {
       if (highest_streaming_message_id < streaming_message.first) {
         highest_streaming_message_id = streaming_message.first;
       }
 
-      auto const message_delete_confirmation = bot_->co_message_delete(streaming_message.first, Settings::Get().GetChannelId(Settings::Channels::kStreams)).sync_wait();
+      if ((cutoff_message_id <= streaming_message.first) || kept_messages_ids.contains(streaming_message.first)) {
+        return;
+      }
+
+      message_deletions.push_back(rest_->CoMessageDelete(streaming_message.first, streams_channel_id));
+    });
+    reconciliation_progress_.messages_scanned += streaming_messages.size();
+
+    for (auto& message_deletion : message_deletions) {
+      auto const message_delete_confirmation = co_await message_deletion;
       if (message_delete_confirmation.is_error()) {
         logger_.Error("Failed to delete message when clearing streaming messages. Error: '{}'", message_delete_confirmation.get_error().human_readable);
-        throw message_delete_confirmation.get_error();
+        ++reconciliation_progress_.failures;
+        continue;
       }
-    });
-  } while (!streaming_messages.empty());
+      ++reconciliation_progress_.messages_deleted;
+    }
+  }
+}
+
+bool Sm64brDiscordBot::IsStreaming(dpp::snowflake const guild_id, dpp::snowflake const user_id) noexcept {
+  auto& guild_state = guild_states_.at(guild_id);
+  std::scoped_lock<std::mutex> const mutex_lock(guild_state.on_presence_update_mutex);
+  return guild_state.streaming_users_ids_and_states.contains(user_id);
+}
+
+std::string Sm64brDiscordBot::GetStatePath(std::string const& path) const {
+  return state_directory_.empty() ? path : (state_directory_ / std::filesystem::path(path).filename()).string();
 }
\ No newline at end of file
@@ -1,50 +1,209 @@
 #pragma once
 
+#include <algorithm>
+#include <atomic>
+#include <chrono>
+#include <cstdint>
+#include <filesystem>
 #include <future>
-#include <list>
 #include <map>
 #include <memory>
 #include <mutex>
+#include <optional>
+#include <set>
+#include <string>
+#include <utility>
+#include <vector>
 
 #include <dpp/dpp.h>
 
+#include "admission/admission_controller.h"
+#include "admission/user_throttle.h"
+#include "awards/awards_tally.h"
+#include "cache/dm_channel_cache.h"
+#include "cache/user_cache_budget.h"
+#include "clip/clip_index.h"
+#include "gateway/cluster_gateway.h"
+#include "gateway/gateway_monitor.h"
+#include "harness/trace.h"
+#include "harness/trace_recorder.h"
+#include "lifecycle/leader_lease.h"
+#include "lifecycle/streaming_log.h"
 #include "logger/logger_factory.h"
+#include "member/member_announcer.h"
+#include "message/deletion_scheduler.h"
+#include "message/direct_messenger.h"
+#include "message/message_event.h"
 #include "message/message_handler.h"
+#include "metrics/latency_histogram.h"
+#include "presence/presence_event.h"
+#include "presence/stream_matcher.h"
+#include "rest/rest.h"
 #include "settings/settings.h"
-//#include "the_run/the_run.h"
+#include "the_run/the_run.h"
 
 class Sm64brDiscordBot final {
 public:
   Sm64brDiscordBot();
   ~Sm64brDiscordBot();
 
-  void Start() const noexcept;
+  Sm64brDiscordBot(std::shared_ptr<Rest> rest);
+
+  bool Start() noexcept;
+  bool Shutdown() noexcept;
+  void Record(std::string const& trace_path);
+  void Replay(std::string const& trace_path, double speed);
 
 private:
   void OnLog(dpp::log_t const& log) const noexcept;
   void OnMessageCreate(dpp::message_create_t const& message_create) noexcept;
   void OnMessageReactionAdd(dpp::message_reaction_add_t const& message_reaction_add) noexcept;
   void OnPresenceUpdate(dpp::presence_update_t const& presence_update) noexcept;
+  void OnSlashCommand(dpp::slashcommand_t const& slash_command) noexcept;
   void OnReady(dpp::ready_t const& ready) const noexcept;
   void OnGuildMemberAdd(dpp::guild_member_add_t const& guild_member_add) const noexcept;
   void OnGuildMemberRemove(dpp::guild_member_remove_t const& guild_member_remove) const noexcept;
 
-  void ClearStreamingRoles() const;
-  void ClearStreamingMessages() const;
+  void HandleMessageCreate(dpp::message const& message) noexcept;
+  void HandleMessageReactionAdd(dpp::snowflake message_id, dpp::snowflake channel_id, dpp::snowflake message_author_id, dpp::snowflake reacting_user_id) noexcept;
+  void HandlePresenceUpdate(dpp::presence const& presence) noexcept;
+  void SubmitPresenceEvent(Settings::Guild const& guild, PresenceEvent presence_event, std::chrono::steady_clock::time_point dispatch_time) noexcept;
+  void TrackStandbyPresence(dpp::presence const& presence) noexcept;
+  void AdoptStreams(std::vector<StreamingLog::Stream> const& streams) noexcept;
+  void RegisterSlashCommands() const noexcept;
+  void StopStreaming(Settings::Guild const& guild, dpp::snowflake user_id, dpp::snowflake message_id) const noexcept;
+  void ScheduleStreamingEdit(Settings::Guild const& guild, dpp::snowflake user_id, std::chrono::steady_clock::duration delay) noexcept;
+  dpp::task<void> EditStreamingMessage(Settings::Guild const& guild, dpp::snowflake user_id) noexcept;
+  void HandleGuildMemberAdd(dpp::snowflake guild_id, dpp::snowflake user_id) const noexcept;
+  void HandleGuildMemberRemove(dpp::snowflake guild_id, dpp::snowflake user_id) const noexcept;
+
+  template <typename Event, typename Handler>
+  void Subscribe(dpp::event_router_t<Event>& event_router, uint32_t const required_intents, Handler&& handler) {
+    event_router(std::forward<Handler>(handler));
+    required_intents_ |= required_intents;
+  }
+
+  void ReportGatewayUsage() const noexcept;
+  void ReportCacheUsage() const noexcept;
+  bool TrimUserCache() const noexcept;
+  void ReportAdmissionUsage() const noexcept;
+  void ReportReconciliation() const noexcept;
+  void RecordFirstHandledEvent() const noexcept;
+
+  void RecordEvent(trace::EventType type, std::string const& raw_event) const noexcept;
+  void DispatchTraceEvent(trace::Event const& event) noexcept;
+  void WaitForPendingWork() noexcept;
+
+  dpp::task<void> Reconcile(std::set<dpp::snowflake> kept_messages_ids) noexcept;
+  dpp::task<void> ClearStreamingRoles(Settings::Guild const& guild) noexcept;
+  dpp::task<void> ClearStreamingMessages(Settings::Guild const& guild, std::set<dpp::snowflake> const& kept_messages_ids, dpp::snowflake cutoff_message_id) noexcept;
+  bool IsStreaming(dpp::snowflake guild_id, dpp::snowflake user_id) noexcept;
+  std::string GetStatePath(std::string const& path) const;
+
+private:
+  // A user is claimed with an empty message id while their streaming message is being created, so
+  // a later presence update neither creates a second message nor deletes one that does not exist
+  // yet. A stop arriving meanwhile is recorded and carried out once the creation completes.
+  // Title or category changes only keep the latest content, which is edited into the message at
+  // most once per edit interval.
+  struct StreamingState {
+    dpp::snowflake message_id;
+    bool stop_requested{};
+    std::string content;
+    std::optional<std::string> pending_content;
+    std::chrono::steady_clock::time_point last_edit;
+    bool edit_scheduled{};
+
+    // Returns how long to wait before editing, or nothing when the message is current or an edit
+    // is already on its way.
+    std::optional<std::chrono::steady_clock::duration> RequestEdit(std::string const& latest_content, std::chrono::steady_clock::duration const edit_interval) {
+      if (latest_content == content) {
+        pending_content.reset();
+      } else {
+        pending_content = latest_content;
+      }
+
+      if (!pending_content || edit_scheduled || message_id.empty()) {
+        return std::nullopt;
+      }
+
+      edit_scheduled = true;
+      return std::max(std::chrono::steady_clock::duration::zero(), last_edit + edit_interval - std::chrono::steady_clock::now());
+    }
+  };
+
+  struct GuildState {
+    std::mutex on_presence_update_mutex;
+    std::map<dpp::snowflake, StreamingState> streaming_users_ids_and_states;
+  };
+
+  struct ReconciliationProgress {
+    std::atomic<std::size_t> guilds{};
+    std::atomic<uint64_t> members_scanned{};
+    std::atomic<uint64_t> roles_cleared{};
+    std::atomic<uint64_t> messages_scanned{};
+    std::atomic<uint64_t> messages_deleted{};
+    std::atomic<uint64_t> failures{};
+    std::atomic<bool> finished{};
+  };
 
 private:
   Logger const logger_ = LoggerFactory::Get().Create("SM64BR Discord Bot");
 
-  std:: shared_ptr<dpp::cluster> const bot_ = std::make_shared<dpp::cluster>(Settings::Get().GetBotToken(), dpp::i_all_intents);
-  
-  MessageHandler message_handler_ = MessageHandler(bot_);
+  std:: shared_ptr<dpp::cluster> const bot_ = std::make_shared<dpp::cluster>(Settings::Get().GetBotToken(), dpp::i_all_intents, Settings::Get().GetGatewaySettings().shards, 0, 1, Settings::Get().GetGatewaySettings().compression, Settings::Get().GetCacheSettings().dpp_policy);
+  uint32_t required_intents_ = dpp::i_guilds;
+
+  // Empty for the live bot. With a REST stand-in, the clip index, tally, DM channels, deletions and
+  // leader lock live in a scratch directory instead, so a replay never writes its fake nominations
+  // into the live files or maps the index a running leader is using.
+  std::filesystem::path const state_directory_;
+  std::shared_ptr<Rest> const rest_;
+
+  std::shared_ptr<DeletionScheduler> const deletion_scheduler_ = std::make_shared<DeletionScheduler>(rest_);
+
+  std::shared_ptr<ClipIndex> const clip_index_ = std::make_shared<ClipIndex>(GetStatePath(Settings::Get().GetClipsSettings().index_path), Settings::Get().GetClipsSettings().initial_capacity);
+
+  std::shared_ptr<AwardsTally> const awards_tally_ = std::make_shared<AwardsTally>(GetStatePath(Settings::Get().GetClipsSettings().tally_path));
+
+  std::shared_ptr<DmChannelCache> const dm_channel_cache_ = std::make_shared<DmChannelCache>(GetStatePath(Settings::Get().GetLifecycleSettings().dm_channels_path));
+  std::shared_ptr<DirectMessenger> const direct_messenger_ = std::make_shared<DirectMessenger>(rest_, dm_channel_cache_);
+
+  std::shared_ptr<UserCacheBudget> const user_cache_budget_ = std::make_shared<UserCacheBudget>(Settings::Get().GetCacheSettings().user_budget_bytes);
+
+  std::shared_ptr<UserThrottle> const user_throttle_ = std::make_shared<UserThrottle>(Settings::Get().GetThrottleSettings());
+
+  MessageHandler message_handler_ = MessageHandler(rest_, deletion_scheduler_, clip_index_, awards_tally_, direct_messenger_, user_throttle_);
+  mutable MemberAnnouncer member_announcer_ = MemberAnnouncer(rest_);
+
+  std::unique_ptr<TraceRecorder> trace_recorder_;
+  mutable LatencyHistogram handler_latency_;
 
-  //TheRun the_run = TheRun(bot_);
+  std::unique_ptr<TheRun> the_run_;
 
-  std::map<dpp::snowflake, dpp::snowflake> streaming_users_ids_and_messages_ids_;
-  std::mutex on_presence_update_mutex_;
+  StreamMatcher const stream_matcher_ = StreamMatcher(Settings::Get().GetStreamRules());
+  std::map<dpp::snowflake, GuildState> guild_states_;
 
-  std::list<std::future<void>> message_create_futures_;
-  std::list<std::future<void>> message_reaction_futures_;
-  std::list<std::future<void>> presence_update_futures_;
+  LeaderLease leader_lease_ = LeaderLease(GetStatePath(Settings::Get().GetLifecycleSettings().leader_lock_path));
+  std::atomic<bool> accepting_events_ = true;
+  // While standing by, the latest presence of each user is kept so the takeover can catch up on
+  // the streams that started, changed or stopped since the leader last wrote the streaming log.
+  std::atomic<bool> standing_by_{};
+  std::mutex standby_presences_mutex_;
+  std::map<AdmissionController::Key, PresenceEvent> standby_presences_;
+  StreamingLog streaming_log_ = StreamingLog(GetStatePath(Settings::Get().GetLifecycleSettings().streams_path));
+  mutable std::atomic<bool> ready_{};
+  mutable std::once_flag slash_commands_registered_;
+  std::mutex lifecycle_mutex_;
+  std::atomic<bool> shutting_down_{};
+  std::promise<void> stopped_;
+  std::future<void> stopped_future_;
+  std::chrono::steady_clock::time_point start_time_;
+  mutable std::atomic<bool> first_event_handled_{};
+  ReconciliationProgress reconciliation_progress_;
+  std::optional<dpp::task<void>> reconciliation_;
+  std::promise<void> reconciled_;
+  std::future<void> reconciled_future_;
+  GatewayMonitor gateway_monitor_ = GatewayMonitor(std::make_shared<ClusterGateway>(bot_), Settings::Get().GetGatewaySettings().health);
+  AdmissionController admission_controller_ = AdmissionController(Settings::Get().GetAdmissionSettings().command_concurrency, Settings::Get().GetAdmissionSettings().message_concurrency,
+                                                                  Settings::Get().GetAdmissionSettings().presence_concurrency, Settings::Get().GetAdmissionSettings().presence_queue_limit);
 };
\ No newline at end of file
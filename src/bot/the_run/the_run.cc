@@ -1,110 +1,138 @@
 #include "the_run.h"
 
+#include <algorithm>
+#include <chrono>
 #include <exception>
 #include <print>
 #include <utility>
 
+#include <boost/asio/co_spawn.hpp>
+#include <boost/asio/detached.hpp>
+#include <boost/asio/ip/tcp.hpp>
+#include <boost/asio/ssl/stream.hpp>
+#include <boost/asio/steady_timer.hpp>
+#include <boost/asio/this_coro.hpp>
+#include <boost/asio/use_awaitable.hpp>
+#include <boost/beast/core.hpp>
+#include <boost/beast/ssl.hpp>
+#include <boost/beast/websocket.hpp>
+#include <boost/beast/websocket/ssl.hpp>
+
 #include "payload_parser.h"
 #include "settings/settings.h"
 
-TheRun::TheRun(std::shared_ptr<dpp::cluster> bot) noexcept :
-  bot_(std::move(bot)) {
-  client_.clear_access_channels(websocketpp::log::alevel::all);
-  client_.clear_error_channels(websocketpp::log::elevel::all);
-
-  client_.init_asio();
-
-  client_.set_tls_init_handler(websocketpp::lib::bind(&TheRun::OnTlsInit, this));
-
-  client_.start_perpetual();
-
-  thread_ = websocketpp::lib::make_shared<websocketpp::lib::thread>(&websocketpp::client<websocketpp::config::asio_tls_client>::run, &client_);
+TheRun::TheRun(std::shared_ptr<Rest> rest, std::string endpoint) noexcept :
+  rest_(std::move(rest)),
+  endpoint_(std::move(endpoint)) {
+  auto parsed_endpoint = ParseEndpoint(endpoint_);
+  if (!parsed_endpoint) {
+    logger_.Error("Invalid The Run endpoint '{}', expected a ws:// or wss:// URL", endpoint_);
+    return;
+  }
 
-  Connect();
+  boost::asio::co_spawn(io_context_, Run(std::move(*parsed_endpoint)), boost::asio::detached);
+  thread_ = std::thread([this]() { io_context_.run(); });
 }
 
 TheRun::~TheRun() {
-  client_.stop_perpetual();
+  io_context_.stop();
+  if (thread_.joinable()) {
+    thread_.join();
+  }
+
+  auto const stats = GetStats();
+  logger_.Info("Processed {} The Run payloads, {} pings", stats.payloads, stats.pings);
+}
 
-  thread_->join();
+TheRun::Stats TheRun::GetStats() const noexcept {
+  return Stats{.payloads = payloads_.load(), .pings = pings_.load()};
 }
 
-std::shared_ptr<boost::asio::ssl::context> TheRun::OnTlsInit() noexcept {
-  auto const ssl_context = std::make_shared<boost::asio::ssl::context>(boost::asio::ssl::context::sslv23);
-  try {
-    ssl_context->set_options(boost::asio::ssl::context::default_workarounds | boost::asio::ssl::context::no_sslv2 | boost::asio::ssl::context::no_sslv3 | boost::asio::ssl::context::single_dh_use);
-  } catch (std::exception const& exception) {
-    logger_.Error("Failed to set The Run SSL context. Error '{}'", exception.what());
+std::optional<TheRun::Endpoint> TheRun::ParseEndpoint(std::string const& url) noexcept {
+  Endpoint endpoint;
+  std::string_view rest_of_url(url);
+  if (rest_of_url.starts_with("wss://")) {
+    endpoint.tls = true;
+    rest_of_url.remove_prefix(6);
+  } else if (rest_of_url.starts_with("ws://")) {
+    rest_of_url.remove_prefix(5);
+  } else {
+    return std::nullopt;
   }
 
-  return ssl_context;
-}
+  auto const target_start = rest_of_url.find('/');
+  endpoint.target = (std::string_view::npos == target_start) ? "/" : std::string(rest_of_url.substr(target_start));
+  auto const authority = rest_of_url.substr(0, target_start);
 
-void TheRun::Connect() noexcept {
-  websocketpp::lib::error_code error_code;
-  auto const connection = client_.get_connection(Settings::Get().GetTheRunEndpoint(), error_code);
-  if (error_code) {
-    logger_.Error("Failed to connect to The Run endpoint '{}'. Error '{}'", Settings::Get().GetTheRunEndpoint(), error_code.message());
-    return;
+  auto const port_start = authority.rfind(':');
+  endpoint.host = std::string(authority.substr(0, port_start));
+  endpoint.port = (std::string_view::npos == port_start) ? (endpoint.tls ? "443" : "80") : std::string(authority.substr(port_start + 1));
+  if (endpoint.host.empty() || endpoint.port.empty()) {
+    return std::nullopt;
   }
 
-  connection_handle_ = connection->get_handle();
-
-  connection->set_open_handler(websocketpp::lib::bind(
-    &TheRun::OnOpen,
-    this,
-    &client_,
-    websocketpp::lib::placeholders::_1
-  ));
-  connection->set_close_handler(websocketpp::lib::bind(
-    &TheRun::OnClose,
-    this,
-    &client_,
-    websocketpp::lib::placeholders::_1
-  ));
-  connection->set_fail_handler(websocketpp::lib::bind(
-    &TheRun::OnFail,
-    this,
-    &client_,
-    websocketpp::lib::placeholders::_1
-  ));
-  connection->set_message_handler(websocketpp::lib::bind(
-    &TheRun::OnMessage,
-    this,
-    websocketpp::lib::placeholders::_1,
-    websocketpp::lib::placeholders::_2
-  ));
-
-  client_.connect(connection);
+  return endpoint;
 }
 
-void TheRun::Disconnect() noexcept {
-  websocketpp::lib::error_code error_code;
-  client_.close(connection_handle_, websocketpp::close::status::going_away, "", error_code);
-  if (error_code) {
-    logger_.Error("Failed to disconnect to The Run endpoint '{}'. Error '{}'", Settings::Get().GetTheRunEndpoint(), error_code.message());
+boost::asio::awaitable<void> TheRun::Run(Endpoint const endpoint) {
+  auto constexpr kConnectTimeout = std::chrono::seconds(30);
+  auto constexpr kReconnectDelay = std::chrono::seconds(5);
+
+  auto const executor = co_await boost::asio::this_coro::executor;
+  while (true) {
+    try {
+      boost::asio::ip::tcp::resolver resolver(executor);
+      auto const results = co_await resolver.async_resolve(endpoint.host, endpoint.port, boost::asio::use_awaitable);
+
+      if (endpoint.tls) {
+        boost::beast::websocket::stream<boost::beast::ssl_stream<boost::beast::tcp_stream>> web_socket(executor, ssl_context_);
+        boost::beast::get_lowest_layer(web_socket).expires_after(kConnectTimeout);
+        co_await boost::beast::get_lowest_layer(web_socket).async_connect(results, boost::asio::use_awaitable);
+        if (!SSL_set_tlsext_host_name(web_socket.next_layer().native_handle(), endpoint.host.c_str())) {
+          throw boost::beast::system_error(boost::beast::error_code(static_cast<int>(::ERR_get_error()), boost::asio::error::get_ssl_category()));
+        }
+        co_await web_socket.next_layer().async_handshake(boost::asio::ssl::stream_base::client, boost::asio::use_awaitable);
+        co_await Read(web_socket, endpoint);
+      } else {
+        boost::beast::websocket::stream<boost::beast::tcp_stream> web_socket(executor);
+        boost::beast::get_lowest_layer(web_socket).expires_after(kConnectTimeout);
+        co_await boost::beast::get_lowest_layer(web_socket).async_connect(results, boost::asio::use_awaitable);
+        co_await Read(web_socket, endpoint);
+      }
+    } catch (boost::beast::system_error const& error) {
+      if (boost::beast::websocket::error::closed == error.code()) {
+        logger_.Info("Connection to The Run endpoint closed");
+      } else {
+        logger_.Error("Connection to The Run endpoint '{}' failed. Error '{}'", endpoint_, error.code().message());
+      }
+    }
+
+    boost::asio::steady_timer reconnect_timer(executor, kReconnectDelay);
+    co_await reconnect_timer.async_wait(boost::asio::use_awaitable);
   }
 }
 
-void TheRun::OnOpen(websocketpp::client<websocketpp::config::asio_tls_client> *const client, websocketpp::connection_hdl const connection_handle) noexcept {
+template <typename WebSocket>
+boost::asio::awaitable<void> TheRun::Read(WebSocket& web_socket, Endpoint const& endpoint) {
+  boost::beast::get_lowest_layer(web_socket).expires_never();
+  web_socket.set_option(boost::beast::websocket::stream_base::timeout::suggested(boost::beast::role_type::client));
+  co_await web_socket.async_handshake(std::format("{}:{}", endpoint.host, endpoint.port), endpoint.target, boost::asio::use_awaitable);
   logger_.Info("Connection to The Run endpoint opened");
-}
 
-void TheRun::OnClose(websocketpp::client<websocketpp::config::asio_tls_client> *const client, websocketpp::connection_hdl const connection_handle) noexcept {
-  logger_.Info("Connection to The Run endpoint closed");
+  boost::beast::flat_buffer buffer;
+  while (true) {
+    co_await web_socket.async_read(buffer, boost::asio::use_awaitable);
+    if (web_socket.got_text()) {
+      OnPayload(boost::beast::buffers_to_string(buffer.data()));
+    }
+    buffer.consume(buffer.size());
+  }
 }
 
-void TheRun::OnFail(websocketpp::client<websocketpp::config::asio_tls_client> *const client, websocketpp::connection_hdl const connection_handle) noexcept {
-  auto const connection = client->get_con_from_hdl(connection_handle);
-  logger_.Error("Connection to The Run endpoint failed. Error '{}'", connection->get_ec().message());
-}
+void TheRun::OnPayload(std::string const& payload) noexcept {
+  ++payloads_;
 
-void TheRun::OnMessage(websocketpp::connection_hdl const handler, websocketpp::client<websocketpp::config::asio_tls_client>::message_ptr const message) noexcept {
-  if (message->get_opcode() != websocketpp::frame::opcode::text) {
-    return;
-  }
- 
-  auto const payload_parser = PayloadParser(message->get_payload());
+  auto const payload_parser = PayloadParser(payload);
   if (!payload_parser.IsPingable()) {
     announced_users_.erase(payload_parser.GetUser());
     return;
@@ -114,9 +142,18 @@ void TheRun::OnMessage(websocketpp::connection_hdl const handler, websocketpp::c
     return;
   }
 
-  logger_.Info("Payload triggered a ping '{}'", message->get_payload());
+  logger_.Info("Payload triggered a ping '{}'", payload);
+
+  std::ranges::for_each(Settings::Get().GetGuilds(), [this, &payload_parser](auto const& guild_id_and_guild) {
+    auto const& guild = guild_id_and_guild.second;
+    auto const pacepals_role_id = guild.GetRoleId(Settings::Roles::kPacepals);
+    if (pacepals_role_id.empty()) {
+      return;
+    }
 
-  auto const pacepals_message = std::format("{}\n{}", dpp::role::get_mention(Settings::Get().GetRoleId(Settings::Roles::kPacepals)),  payload_parser.GetString());
-  bot_->message_create(dpp::message(Settings::Get().GetChannelId(Settings::Channels::kGeneral), pacepals_message));
+    auto const pacepals_message = std::format("{}\n{}", dpp::role::get_mention(pacepals_role_id), payload_parser.GetString());
+    rest_->MessageCreate(dpp::message(guild.GetChannelId(Settings::Channels::kGeneral), pacepals_message));
+  });
   announced_users_.insert(payload_parser.GetUser());
+  ++pings_;
 }
\ No newline at end of file
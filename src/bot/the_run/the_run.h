@@ -1,41 +1,69 @@
 #pragma once
 
+#include <atomic>
+#include <cstdint>
 #include <memory>
+#include <optional>
 #include <set>
 #include <string>
+#include <thread>
+#include <utility>
 
-#include <dpp/dpp.h>
-#include <websocketpp/client.hpp>
-#include <websocketpp/config/asio_client.hpp>
+#include <boost/asio/awaitable.hpp>
+#include <boost/asio/io_context.hpp>
+#include <boost/asio/ssl/context.hpp>
 
 #include "logger/logger_factory.h"
+#include "rest/rest.h"
 
+// Follows the therun.gg live feed and pings each guild's pacepals when an SM64 run is on pace.
+// The endpoint may be wss://, like the live feed, or plain ws://, like the local feed stand-in.
+// The connection is reopened a few seconds after it drops.
 class TheRun final {
 public:
+  struct Stats {
+    uint64_t payloads{};
+    uint64_t pings{};
+  };
+
   TheRun() = delete;
   ~TheRun();
 
-  TheRun(std::shared_ptr<dpp::cluster> bot) noexcept;
+  TheRun(std::shared_ptr<Rest> rest, std::string endpoint) noexcept;
+
+  TheRun(TheRun const&) = delete;
+  void operator=(TheRun const&) = delete;
+
+  Stats GetStats() const noexcept;
 
 private:
-  void Connect() noexcept;
-  void Disconnect() noexcept;
+  struct Endpoint {
+    bool tls{};
+    std::string host;
+    std::string port;
+    std::string target;
+  };
+
+  static std::optional<Endpoint> ParseEndpoint(std::string const& url) noexcept;
 
-  std::shared_ptr<boost::asio::ssl::context> OnTlsInit() noexcept;
+  boost::asio::awaitable<void> Run(Endpoint endpoint);
 
-  void OnOpen(websocketpp::client<websocketpp::config::asio_tls_client> *const client, websocketpp::connection_hdl const connection_handle) noexcept;
-  void OnClose(websocketpp::client<websocketpp::config::asio_tls_client> *const client, websocketpp::connection_hdl const connection_handle) noexcept;
-  void OnFail(websocketpp::client<websocketpp::config::asio_tls_client> *const client, websocketpp::connection_hdl const connection_handle) noexcept;
-  void OnMessage(websocketpp::connection_hdl const handler, websocketpp::client<websocketpp::config::asio_tls_client>::message_ptr const message) noexcept;
+  template <typename WebSocket>
+  boost::asio::awaitable<void> Read(WebSocket& web_socket, Endpoint const& endpoint);
+
+  void OnPayload(std::string const& payload) noexcept;
 
 private:
   Logger const logger_ = LoggerFactory::Get().Create("The Run");
 
-  std::shared_ptr<dpp::cluster> const bot_;
-
-  websocketpp::client<websocketpp::config::asio_tls_client> client_;
-  websocketpp::lib::shared_ptr<websocketpp::lib::thread> thread_;
-  websocketpp::connection_hdl connection_handle_;
+  std::shared_ptr<Rest> const rest_;
+  std::string const endpoint_;
 
   std::set<std::string> announced_users_;
+  std::atomic<uint64_t> payloads_{};
+  std::atomic<uint64_t> pings_{};
+
+  boost::asio::ssl::context ssl_context_ = boost::asio::ssl::context(boost::asio::ssl::context::tls_client);
+  boost::asio::io_context io_context_;
+  std::thread thread_;
 };
\ No newline at end of file
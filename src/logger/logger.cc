@@ -2,8 +2,8 @@
 
 #include <utility>
 
-Logger::Logger(std::shared_ptr<spdlog::async_logger>&& logger) noexcept
-  : logger_(std::move(logger)) {
+Logger::Logger(std::shared_ptr<spdlog::async_logger>&& logger, std::shared_ptr<RepeatFilter>&& repeat_filter) noexcept
+  : logger_(std::move(logger)), repeat_filter_(std::move(repeat_filter)) {
 
 }
 
@@ -6,12 +6,14 @@
 
 #include <spdlog/async.h>
 
+#include "repeat_filter.h"
+
 class Logger final {
 public:
   Logger() = delete;
   ~Logger();
 
-  Logger(std::shared_ptr<spdlog::async_logger>&& logger_) noexcept;
+  Logger(std::shared_ptr<spdlog::async_logger>&& logger_, std::shared_ptr<RepeatFilter>&& repeat_filter) noexcept;
 
   template <typename... Args>
   void Trace(std::format_string<Args...> fmt, Args&&... args) const noexcept {
@@ -34,21 +36,23 @@ public:
   template <typename... Args>
   void Warn(std::format_string<Args...> fmt, Args&&... args) const noexcept {
     auto const message = std::format(fmt, std::forward<Args>(args)...);
-    logger_->warn(message);
+    repeat_filter_->Log(spdlog::level::warn, fmt.get(), message);
   }
 
   template <typename... Args>
   void Error(std::format_string<Args...> fmt, Args&&... args) const noexcept {
     auto const message = std::format(fmt, std::forward<Args>(args)...);
-    logger_->error(message);
+    repeat_filter_->Log(spdlog::level::err, fmt.get(), message);
   }
 
   template <typename... Args>
   void Critical(std::format_string<Args...> fmt, Args&&... args) const noexcept {
     auto const message = std::format(fmt, std::forward<Args>(args)...);
+    // Never held back, however often it repeats.
     logger_->critical(message);
   }
 
 private:
   std::shared_ptr<spdlog::async_logger> const logger_;
+  std::shared_ptr<RepeatFilter> const repeat_filter_;
 };
\ No newline at end of file
@@ -1,8 +1,70 @@
 #include "logger_factory.h"
 
+#include <array>
+#include <filesystem>
+#include <fstream>
 #include <ranges>
+#include <system_error>
 
 #include <spdlog/async.h>
+#include <zlib.h>
+
+namespace {
+  // The logger factory is created by the first logger, which may come before the settings file is
+  // known to be readable; that error is left for the bot to report.
+  Settings::LoggingSettings LoadLoggingSettings() noexcept {
+    try {
+      return Settings::Get().GetLoggingSettings();
+    } catch (...) {
+      return Settings::LoggingSettings{};
+    }
+  }
+
+  spdlog::async_overflow_policy LogOverflowToPolicy(Settings::LogOverflow const overflow) noexcept {
+    switch (overflow) {
+      case Settings::LogOverflow::kBlock:
+        return spdlog::async_overflow_policy::block;
+      case Settings::LogOverflow::kDropNew:
+        return spdlog::async_overflow_policy::discard_new;
+      case Settings::LogOverflow::kDropOldest:
+        break;
+    }
+    return spdlog::async_overflow_policy::overrun_oldest;
+  }
+
+  bool Compress(std::filesystem::path const& path) noexcept {
+    auto const compressed_path = std::filesystem::path(path).concat(".gz");
+    auto const partial_path = std::filesystem::path(compressed_path).concat(".partial");
+
+    std::ifstream input(path, std::ios::binary);
+    auto* const output = gzopen(partial_path.c_str(), "wb");
+    if (!input || (nullptr == output)) {
+      if (nullptr != output) {
+        gzclose(output);
+      }
+      return false;
+    }
+
+    std::array<char, 64 * 1024> buffer;
+    auto written = true;
+    while (written && input) {
+      input.read(buffer.data(), buffer.size());
+      auto const count = static_cast<int>(input.gcount());
+      written = (0 == count) || (count == gzwrite(output, buffer.data(), static_cast<unsigned>(count)));
+    }
+    written = (Z_OK == gzclose(output)) && written && input.eof();
+
+    std::error_code error;
+    if (written) {
+      std::filesystem::rename(partial_path, compressed_path, error);
+    }
+    if (!written || error) {
+      std::filesystem::remove(partial_path, error);
+      return false;
+    }
+    return true;
+  }
+}
 
 LoggerFactory& LoggerFactory::Get() noexcept {
   static LoggerFactory LoggerFactory;
@@ -10,14 +72,94 @@ LoggerFactory& LoggerFactory::Get() noexcept {
 }
 
 LoggerFactory::LoggerFactory() noexcept
-  : sinks_{stdout_sink_, file_sink_} {
-  spdlog::init_thread_pool(8192, 2);
+  : settings_(::LoadLoggingSettings()), sinks_{stdout_sink_, file_sink_} {
+  spdlog::init_thread_pool(settings_.queue_size, 2);
+  maintenance_logger_ = std::make_shared<spdlog::async_logger>("Logger", sinks_.begin(), sinks_.end(), spdlog::thread_pool(), ::LogOverflowToPolicy(settings_.overflow));
+  maintenance_thread_ = std::thread([this]() { RunMaintenance(); });
 }
 
 LoggerFactory::~LoggerFactory() {
+  {
+    std::scoped_lock<std::mutex> const mutex_lock(mutex_);
+    stopping_ = true;
+  }
+  maintenance_condition_.notify_all();
+  maintenance_thread_.join();
+
+  maintenance_logger_->flush();
   std::ranges::for_each(sinks_, [](auto const& sink) { sink->flush(); });
 }
 
 Logger LoggerFactory::Create(std::string const& name) const noexcept {
-  return Logger(std::make_shared<spdlog::async_logger>(name, sinks_.begin(), sinks_.end(), spdlog::thread_pool()));
+  auto logger = std::make_shared<spdlog::async_logger>(name, sinks_.begin(), sinks_.end(), spdlog::thread_pool(), ::LogOverflowToPolicy(settings_.overflow));
+  auto repeat_filter = std::make_shared<RepeatFilter>(logger, settings_.repeat_window);
+  {
+    std::scoped_lock<std::mutex> const mutex_lock(mutex_);
+    repeat_filters_.push_back(repeat_filter);
+  }
+  return Logger(std::move(logger), std::move(repeat_filter));
+}
+
+void LoggerFactory::RunMaintenance() noexcept {
+  auto constexpr kMaintenanceInterval = std::chrono::seconds(1);
+  auto constexpr kCompressionInterval = std::chrono::minutes(1);
+  auto next_compression = std::chrono::steady_clock::now();
+
+  std::unique_lock<std::mutex> mutex_lock(mutex_);
+  while (!maintenance_condition_.wait_for(mutex_lock, kMaintenanceInterval, [this]() { return stopping_; })) {
+    std::erase_if(repeat_filters_, [](auto const& repeat_filter) { return repeat_filter.expired(); });
+    auto const repeat_filters = repeat_filters_;
+    mutex_lock.unlock();
+
+    std::ranges::for_each(repeat_filters, [](auto const& weak_repeat_filter) {
+      if (auto const repeat_filter = weak_repeat_filter.lock()) {
+        repeat_filter->Summarize();
+      }
+    });
+    ReportDrops();
+
+    auto const now = std::chrono::steady_clock::now();
+    if (settings_.compress_rotated && (next_compression <= now)) {
+      CompressRotatedFiles();
+      next_compression = now + kCompressionInterval;
+    }
+
+    mutex_lock.lock();
+  }
+}
+
+void LoggerFactory::ReportDrops() noexcept {
+  auto const now = std::chrono::steady_clock::now();
+  if (now - last_drop_report_ < settings_.repeat_window) {
+    return;
+  }
+
+  auto const overruns = spdlog::thread_pool()->overrun_counter();
+  auto const discards = spdlog::thread_pool()->discard_counter();
+  if ((overruns == reported_overruns_) && (discards == reported_discards_)) {
+    return;
+  }
+
+  maintenance_logger_->warn("Log queue was full, dropped {} oldest and {} new messages", overruns - reported_overruns_, discards - reported_discards_);
+  reported_overruns_ = overruns;
+  reported_discards_ = discards;
+  last_drop_report_ = now;
+}
+
+void LoggerFactory::CompressRotatedFiles() const noexcept {
+  auto const current_path = std::filesystem::path(file_sink_->filename());
+
+  std::error_code error;
+  for (auto const& entry : std::filesystem::directory_iterator(current_path.parent_path(), error)) {
+    auto const& path = entry.path();
+    if (!entry.is_regular_file(error) || (".txt" != path.extension()) || !path.stem().string().starts_with("log_") || (current_path == path)) {
+      continue;
+    }
+
+    if (!::Compress(path)) {
+      maintenance_logger_->error("Failed to compress rotated log file '{}'", path.string());
+      continue;
+    }
+    std::filesystem::remove(path, error);
+  }
 }
\ No newline at end of file
@@ -1,7 +1,12 @@
 #pragma once
 
+#include <chrono>
+#include <condition_variable>
+#include <cstdint>
 #include <memory>
+#include <mutex>
 #include <string>
+#include <thread>
 #include <vector>
 
 #include <spdlog/common.h>
@@ -9,7 +14,12 @@
 #include <spdlog/sinks/stdout_color_sinks.h>
 
 #include "logger.h"
+#include "repeat_filter.h"
+#include "settings/settings.h"
 
+// Loggers share the sinks and one async queue, whose overflow policy comes from `bot.logging`.
+// A maintenance thread logs the summaries of repeated messages, reports messages dropped by a full
+// queue and compresses the files the daily sink rotated away from, so logging threads never do.
 class LoggerFactory final {
 public:
   static LoggerFactory& Get() noexcept;
@@ -23,8 +33,26 @@ private:
   LoggerFactory(LoggerFactory const&) = delete;
   void operator=(LoggerFactory const&) = delete;
 
+  void RunMaintenance() noexcept;
+  void ReportDrops() noexcept;
+  void CompressRotatedFiles() const noexcept;
+
 private:
+  Settings::LoggingSettings const settings_;
+
   std::shared_ptr<spdlog::sinks::stdout_color_sink_mt> const stdout_sink_ = std::make_shared<spdlog::sinks::stdout_color_sink_mt>();
   std::shared_ptr<spdlog::sinks::daily_file_sink_mt> const file_sink_ = std::make_shared<spdlog::sinks::daily_file_sink_mt>("logs/log.txt", 0, 0);
   std::vector<spdlog::sink_ptr> const sinks_;
+  std::shared_ptr<spdlog::async_logger> maintenance_logger_;
+
+  mutable std::mutex mutex_;
+  std::condition_variable maintenance_condition_;
+  bool stopping_{};
+  mutable std::vector<std::weak_ptr<RepeatFilter>> repeat_filters_;
+
+  std::size_t reported_overruns_{};
+  std::size_t reported_discards_{};
+  std::chrono::steady_clock::time_point last_drop_report_;
+
+  std::thread maintenance_thread_;
 };
\ No newline at end of file
@@ -0,0 +1,67 @@
+#include "repeat_filter.h"
+
+#include <format>
+#include <utility>
+#include <vector>
+
+RepeatFilter::RepeatFilter(std::shared_ptr<spdlog::async_logger> logger, std::chrono::steady_clock::duration const window) noexcept
+  : logger_(std::move(logger)), window_(window) {
+
+}
+
+void RepeatFilter::Log(spdlog::level::level_enum const level, std::string_view const format, std::string const& message) noexcept {
+  // Bounds the memory spent on distinct keys; past it, new keys are logged unfiltered.
+  std::size_t constexpr kMaxTrackedKeys = 256;
+  std::string_view constexpr kPassThroughFormat = "{}";
+
+  if (0 == window_.count()) {
+    logger_->log(level, message);
+    return;
+  }
+
+  {
+    auto const now = std::chrono::steady_clock::now();
+    std::scoped_lock<std::mutex> const mutex_lock(mutex_);
+    auto key = std::pair{level, std::string((kPassThroughFormat == format) ? std::string_view(message) : format)};
+    auto const it_repeat = repeats_.find(key);
+    if ((repeats_.cend() != it_repeat) && (now - it_repeat->second.window_start < window_)) {
+      ++it_repeat->second.count;
+      ++suppressed_;
+      return;
+    }
+
+    if ((repeats_.cend() == it_repeat) && (kMaxTrackedKeys > repeats_.size())) {
+      repeats_.try_emplace(std::move(key), Repeat{.first_message = message, .window_start = now});
+    }
+  }
+
+  logger_->log(level, message);
+}
+
+void RepeatFilter::Summarize() noexcept {
+  std::vector<std::pair<spdlog::level::level_enum, Repeat>> ended_repeats;
+  {
+    auto const now = std::chrono::steady_clock::now();
+    std::scoped_lock<std::mutex> const mutex_lock(mutex_);
+    for (auto it_repeat = repeats_.begin(); it_repeat != repeats_.end();) {
+      if (now - it_repeat->second.window_start < window_) {
+        ++it_repeat;
+        continue;
+      }
+
+      auto repeat = repeats_.extract(it_repeat++);
+      if (0 != repeat.mapped().count) {
+        ended_repeats.emplace_back(repeat.key().first, std::move(repeat.mapped()));
+      }
+    }
+  }
+
+  for (auto const& [level, repeat] : ended_repeats) {
+    logger_->log(level, std::format("Messages like this one repeated {} times in {} s: {}", repeat.count, std::chrono::duration_cast<std::chrono::seconds>(window_).count(), repeat.first_message));
+  }
+}
+
+uint64_t RepeatFilter::GetSuppressed() const noexcept {
+  std::scoped_lock<std::mutex> const mutex_lock(mutex_);
+  return suppressed_;
+}
\ No newline at end of file
@@ -0,0 +1,46 @@
+#pragma once
+
+#include <chrono>
+#include <cstdint>
+#include <map>
+#include <memory>
+#include <mutex>
+#include <string>
+#include <string_view>
+#include <utility>
+
+#include <spdlog/async_logger.h>
+
+// Passes a message through to the logger only the first time its format string is seen at its
+// level within a window, so repeats that differ only in their arguments (ids, status codes) are
+// caught too. A format that only passes a message through, as DPP's log lines are, is keyed on the
+// message itself, so only identical lines are held back. Repeats inside the window are counted, and Summarize logs how many were held back
+// once the window ends, so a storm of errors costs one queued line per window instead of one per
+// occurrence.
+class RepeatFilter final {
+public:
+  RepeatFilter() = delete;
+  ~RepeatFilter() = default;
+
+  RepeatFilter(std::shared_ptr<spdlog::async_logger> logger, std::chrono::steady_clock::duration window) noexcept;
+
+  void Log(spdlog::level::level_enum level, std::string_view format, std::string const& message) noexcept;
+  void Summarize() noexcept;
+
+  uint64_t GetSuppressed() const noexcept;
+
+private:
+  struct Repeat {
+    std::string first_message;
+    std::chrono::steady_clock::time_point window_start;
+    uint64_t count{};
+  };
+
+private:
+  std::shared_ptr<spdlog::async_logger> const logger_;
+  std::chrono::steady_clock::duration const window_;
+
+  mutable std::mutex mutex_;
+  std::map<std::pair<spdlog::level::level_enum, std::string>, Repeat> repeats_;
+  uint64_t suppressed_{};
+};
\ No newline at end of file
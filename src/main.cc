@@ -1,13 +1,162 @@
 #include <cstdlib>
 #include <exception>
 #include <iostream>
+#include <iterator>
+#include <memory>
+#include <optional>
+#include <span>
+#include <stdexcept>
+#include <string>
+#include <string_view>
+#include <thread>
 
+#include <pthread.h>
+#include <signal.h>
+#include <unistd.h>
+
+#include "bot/harness/allocation_benchmark.h"
+#include "bot/harness/dm_benchmark.h"
+#include "bot/harness/event_benchmark.h"
+#include "bot/harness/gateway_drill.h"
+#include "bot/harness/rest_stand_in.h"
+#include "bot/harness/stream_benchmark.h"
+#include "bot/harness/the_run_benchmark.h"
+#include "bot/harness/the_run_feed_stand_in.h"
 #include "bot/sm64br_discord_bot.h"
 
+namespace {
+  struct Options {
+    std::optional<std::string> record_path;
+    std::optional<std::string> replay_path;
+    double replay_speed = 1.0;
+    bool gateway_drill{};
+    bool dm_benchmark{};
+    bool event_benchmark{};
+    bool allocation_benchmark{};
+    bool stream_benchmark{};
+    bool the_run_feed{};
+    bool the_run_benchmark{};
+  };
+
+  Options ParseOptions(std::span<char const *const> const arguments) {
+    Options options;
+    for (auto it = arguments.begin(); it != arguments.end(); ++it) {
+      auto const argument = std::string_view(*it);
+      auto const next_value = [&it, &arguments, &argument]() {
+        if (std::next(it) == arguments.end()) {
+          throw std::invalid_argument(std::string("Missing value for ").append(argument));
+        }
+        return std::string(*++it);
+      };
+
+      if (argument == "--record") {
+        options.record_path = next_value();
+      } else if (argument == "--replay") {
+        options.replay_path = next_value();
+      } else if (argument == "--speed") {
+        options.replay_speed = std::stod(next_value());
+      } else if (argument == "--gateway-drill") {
+        options.gateway_drill = true;
+      } else if (argument == "--dm-benchmark") {
+        options.dm_benchmark = true;
+      } else if (argument == "--event-benchmark") {
+        options.event_benchmark = true;
+      } else if (argument == "--allocation-benchmark") {
+        options.allocation_benchmark = true;
+      } else if (argument == "--stream-benchmark") {
+        options.stream_benchmark = true;
+      } else if (argument == "--the-run-feed") {
+        options.the_run_feed = true;
+      } else if (argument == "--the-run-benchmark") {
+        options.the_run_benchmark = true;
+      } else {
+        throw std::invalid_argument(std::string("Unknown argument ").append(argument));
+      }
+    }
+
+    return options;
+  }
+
+  // Serves the therun.gg feed stand-in on its configured port until SIGTERM or SIGINT, for a bot
+  // whose the_run.endpoint points at it.
+  void RunTheRunFeed() {
+    sigset_t shutdown_signals;
+    sigemptyset(&shutdown_signals);
+    sigaddset(&shutdown_signals, SIGTERM);
+    sigaddset(&shutdown_signals, SIGINT);
+    pthread_sigmask(SIG_BLOCK, &shutdown_signals, nullptr);
+
+    TheRunFeedStandIn feed(Settings::Get().GetHarnessSettings().the_run_feed);
+    int signal{};
+    sigwait(&shutdown_signals, &signal);
+  }
+}
+
 int main(const int argc, char const *const *const argv) {
   try {
+    auto const options = ::ParseOptions(std::span<char const *const>(argv + 1, static_cast<std::size_t>(argc - 1)));
+
+    if (options.gateway_drill) {
+      return GatewayDrill().Run() ? EXIT_SUCCESS : EXIT_FAILURE;
+    }
+
+    if (options.dm_benchmark) {
+      return DmBenchmark().Run() ? EXIT_SUCCESS : EXIT_FAILURE;
+    }
+
+    if (options.event_benchmark) {
+      return EventBenchmark().Run() ? EXIT_SUCCESS : EXIT_FAILURE;
+    }
+
+    if (options.allocation_benchmark) {
+      return AllocationBenchmark().Run() ? EXIT_SUCCESS : EXIT_FAILURE;
+    }
+
+    if (options.stream_benchmark) {
+      return StreamBenchmark().Run() ? EXIT_SUCCESS : EXIT_FAILURE;
+    }
+
+    if (options.the_run_feed) {
+      ::RunTheRunFeed();
+      return EXIT_SUCCESS;
+    }
+
+    if (options.the_run_benchmark) {
+      return TheRunBenchmark().Run() ? EXIT_SUCCESS : EXIT_FAILURE;
+    }
+
+    if (options.replay_path) {
+      Sm64brDiscordBot bot(std::make_shared<RestStandIn>());
+      bot.Replay(*options.replay_path, options.replay_speed);
+      return EXIT_SUCCESS;
+    }
+
+    sigset_t shutdown_signals;
+    sigemptyset(&shutdown_signals);
+    sigaddset(&shutdown_signals, SIGTERM);
+    sigaddset(&shutdown_signals, SIGINT);
+    pthread_sigmask(SIG_BLOCK, &shutdown_signals, nullptr);
+
     Sm64brDiscordBot bot;
-    bot.Start();
+    if (options.record_path) {
+      bot.Record(*options.record_path);
+    }
+
+    std::thread shutdown_thread([&bot, &shutdown_signals]() {
+      int signal{};
+      sigwait(&shutdown_signals, &signal);
+      bot.Shutdown();
+    });
+
+    auto const started = bot.Start();
+    if (!started) {
+      kill(getpid(), SIGTERM);
+    }
+    shutdown_thread.join();
+
+    if (!started) {
+      return EXIT_FAILURE;
+    }
   } catch (std::exception const& exception) {
     std::cerr << exception.what();
     return EXIT_FAILURE;